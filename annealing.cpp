@@ -0,0 +1,155 @@
+#include "heuristics.h"
+#include "crossings.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Simulated annealing on crossings: swaps and moves into empty
+// cells, every delta from the moved vertices' edges only
+//------------------------------------------------------------
+
+namespace {
+
+// Temperature falls geometrically from StartTemperature to EndTemperature
+// over the time budget (units: crossings)
+const double StartTemperature = 1.5;
+const double EndTemperature = 0.02;
+
+// Clock, cancel flag and temperature are refreshed every CheckInterval moves
+const int CheckInterval = 16;
+
+// Moves go to cells at most MoveRadius grid steps away from the anchor
+const int MoveRadius = 3;
+
+} // namespace
+
+vector<int> annealing_assignment(
+    int V,
+    const CsrGraph& g,
+    const vector<int>& initial_assignment,
+    const vector<pair<double,double>>& coords,
+    int r,
+    unsigned seed,
+    int timeBudgetMs,
+    const SolverControl& control)
+{
+    vector<int> A = initial_assignment;
+    if (V <= 1 || g.edgeCount() < 2 || timeBudgetMs <= 0) return A;
+
+    using Clock = chrono::steady_clock;
+    const auto start = Clock::now();
+    const double budget = (double)timeBudgetMs;
+
+    mt19937 rng(seed);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    vector<pair<double,double>> positions(V);
+    for (int v = 0; v < V; v++) positions[v] = coords[A[v]];
+
+    EdgeIndex index;
+    index.build(positions, g.edges);
+    const auto& edges = index.edgeList();
+
+    vector<int> occupant(coords.size(), -1);
+    for (int v = 0; v < V; v++) occupant[A[v]] = v;
+
+    // Crossings on edges at u or w (w may be -1), each pair once: pairs of
+    // two such edges are only taken from u's side
+    vector<int> hits;
+    auto touches = [&](int e, int x) { return edges[e].first == x || edges[e].second == x; };
+    auto local_crossings = [&](int u, int w) {
+        const auto& pos = index.positions();
+        int count = 0;
+        for (int e : index.incidentEdges(u)) {
+            int a = edges[e].first, b = edges[e].second;
+            count += index.segmentCrossings(pos[a].first, pos[a].second, pos[b].first, pos[b].second, a, b);
+        }
+        if (w < 0) return count;
+        for (int e : index.incidentEdges(w)) {
+            if (touches(e, u)) continue;
+            int a = edges[e].first, b = edges[e].second;
+            hits.clear();
+            index.segmentCrossings(pos[a].first, pos[a].second, pos[b].first, pos[b].second, a, b, &hits);
+            for (int f : hits)
+                if (!touches(f, u)) count++;
+        }
+        return count;
+    };
+
+    // u goes to cell `to`; its occupant w, if any, takes u's old cell
+    auto apply = [&](int u, int to) {
+        int from = A[u], w = occupant[to];
+        A[u] = to;
+        occupant[to] = u;
+        occupant[from] = w;
+        index.moveVertex(u, coords[to].first, coords[to].second);
+        if (w >= 0) {
+            A[w] = from;
+            index.moveVertex(w, coords[from].first, coords[from].second);
+        }
+    };
+
+    // Cell near an anchor point, clamped to the grid
+    auto cell_near = [&](double x, double y) {
+        int cx = clamp((int)lround(x) + (int)(rng() % (2 * MoveRadius + 1)) - MoveRadius, 0, r - 1);
+        int cy = clamp((int)lround(y) + (int)(rng() % (2 * MoveRadius + 1)) - MoveRadius, 0, r - 1);
+        return cy * r + cx;
+    };
+
+    int current = index.countCrossings();
+    int best = current;
+
+    // Moves since the best layout, undone at the end instead of copying
+    // the assignment at every improvement
+    vector<pair<int,int>> sinceBest;   // (vertex, cell before the move)
+    double temperature = StartTemperature;
+
+    for (long long iter = 0; current > 0; iter++) {
+        if (iter % CheckInterval == 0) {
+            double elapsed = chrono::duration<double, milli>(Clock::now() - start).count();
+            if (elapsed >= budget || control.cancelled()) break;
+            temperature = StartTemperature * pow(EndTemperature / StartTemperature, elapsed / budget);
+        }
+
+        // Half the moves aim at the neighbours' barycenter, half stay local
+        int u = (int)(rng() % V);
+        double ax = coords[A[u]].first, ay = coords[A[u]].second;
+        if (g.degree(u) > 0 && (rng() & 1)) {
+            ax = ay = 0;
+            for (int w : g.neighbours(u)) {
+                ax += coords[A[w]].first;
+                ay += coords[A[w]].second;
+            }
+            ax /= g.degree(u);
+            ay /= g.degree(u);
+        }
+        int to = cell_near(ax, ay);
+        if (to == A[u] || to >= (int)coords.size()) continue;
+
+        int from = A[u], w = occupant[to];
+        int before = local_crossings(u, w);
+        apply(u, to);
+        int delta = local_crossings(u, w) - before;
+
+        if (delta <= 0 || unit(rng) < exp(-delta / temperature)) {
+            current += delta;
+            sinceBest.emplace_back(u, from);
+            if (current < best) {
+                best = current;
+                sinceBest.clear();
+            }
+        } else {
+            apply(u, from);
+        }
+    }
+
+    // Back to the best layout seen
+    for (auto it = sinceBest.rbegin(); it != sinceBest.rend(); ++it)
+        apply(it->first, it->second);
+
+    return A;
+}
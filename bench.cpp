@@ -0,0 +1,599 @@
+#include "solver.h"
+#include "heuristics.h"
+#include "crossings.h"
+#include "csrgraph.h"
+#include "benchrender.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Solver / crossing counter / rendering benchmarks.
+// One record per measurement, as JSON lines (default) or CSV.
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Heap accounting: every operator new of the process is counted, so a
+// stage reports the peak of live heap bytes it added on top of what was
+// allocated before it started
+//------------------------------------------------------------
+
+static atomic<long long> heapCurrent(0);
+static atomic<long long> heapPeak(0);
+static const size_t HeapHeader = alignof(max_align_t);
+
+static void* trackedAlloc(size_t size)
+{
+    void* p = malloc(size + HeapHeader);
+    if (!p) return nullptr;
+    *static_cast<size_t*>(p) = size;
+
+    long long now = heapCurrent.fetch_add((long long)size) + (long long)size;
+    long long peak = heapPeak.load();
+    while (now > peak && !heapPeak.compare_exchange_weak(peak, now)) {}
+    return static_cast<char*>(p) + HeapHeader;
+}
+
+static void trackedFree(void* p)
+{
+    if (!p) return;
+    char* base = static_cast<char*>(p) - HeapHeader;
+    heapCurrent.fetch_sub((long long)*reinterpret_cast<size_t*>(base));
+    free(base);
+}
+
+void* operator new(size_t size)
+{
+    if (void* p = trackedAlloc(size)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return trackedAlloc(size); }
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { trackedFree(p); }
+
+namespace {
+
+struct Measure {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long heapBase = heapCurrent.load();
+
+    Measure() { heapPeak = heapBase; }
+
+    double ms() const
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+    long long peakBytes() const { return max(0LL, heapPeak.load() - heapBase); }
+};
+
+long long maxRssKb()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;   // kilobytes on Linux
+}
+
+//------------------------------------------------------------
+// Seeded graph families
+//------------------------------------------------------------
+
+using Adj = vector<vector<int>>;
+
+struct EdgeSet {
+    int n;
+    set<pair<int,int>> edges;
+
+    explicit EdgeSet(int n) : n(n) {}
+
+    bool add(int u, int v)
+    {
+        if (u == v || u < 0 || v < 0 || u >= n || v >= n) return false;
+        return edges.insert({min(u, v), max(u, v)}).second;
+    }
+
+    Adj adjacency() const
+    {
+        Adj adj(n);
+        for (const auto& e : edges) {
+            adj[e.first].push_back(e.second);
+            adj[e.second].push_back(e.first);
+        }
+        return adj;
+    }
+};
+
+// The standard distributions and std::shuffle are implementation-defined,
+// so the graphs are built from raw mt19937 output (fully specified) with
+// these mappings instead, and come out the same under every library
+
+// Uniform in [0, n), n > 0: rejection keeps it unbiased
+size_t uniformIndex(mt19937& rng, size_t n)
+{
+    const uint32_t bound = (uint32_t)n;
+    const uint32_t threshold = (0u - bound) % bound;
+    for (;;) {
+        uint32_t x = (uint32_t)rng();
+        if (x >= threshold) return x % bound;
+    }
+}
+
+// Uniform in [0, 1)
+double unitReal(mt19937& rng)
+{
+    return (uint32_t)rng() / 4294967296.0;
+}
+
+// Fisher-Yates
+template <class T>
+void shuffleVector(vector<T>& v, mt19937& rng)
+{
+    for (size_t i = v.size(); i > 1; i--)
+        swap(v[i - 1], v[uniformIndex(rng, i)]);
+}
+
+// Uniform random simple graph with n vertices and m edges
+Adj randomGnm(int n, int m, mt19937& rng)
+{
+    EdgeSet g(n);
+    long long maxEdges = (long long)n * (n - 1) / 2;
+    m = (int)min<long long>(m, maxEdges);
+    while ((int)g.edges.size() < m) {
+        // Two statements: argument evaluation order is unspecified
+        int u = (int)uniformIndex(rng, n);
+        int v = (int)uniformIndex(rng, n);
+        g.add(u, v);
+    }
+    return g.adjacency();
+}
+
+// Square lattice, row by row, exactly n vertices
+Adj gridGraph(int n)
+{
+    EdgeSet g(n);
+    int w = max(1, (int)ceil(sqrt((double)n)));
+    for (int i = 0; i < n; i++) {
+        if ((i + 1) % w != 0) g.add(i, i + 1);
+        g.add(i, i + w);
+    }
+    return g.adjacency();
+}
+
+// Maximal planar graph: random stacked triangulation (3n - 6 edges)
+Adj planarTriangulation(int n, mt19937& rng)
+{
+    EdgeSet g(n);
+    if (n < 3) {
+        if (n == 2) g.add(0, 1);
+        return g.adjacency();
+    }
+
+    vector<array<int, 3>> faces = {{0, 1, 2}};
+    g.add(0, 1); g.add(1, 2); g.add(0, 2);
+    for (int v = 3; v < n; v++) {
+        size_t f = uniformIndex(rng, faces.size());
+        array<int, 3> t = faces[f];
+        g.add(v, t[0]); g.add(v, t[1]); g.add(v, t[2]);
+        faces[f] = {t[0], t[1], v};
+        faces.push_back({t[1], t[2], v});
+        faces.push_back({t[0], t[2], v});
+    }
+    return g.adjacency();
+}
+
+// k-planar by construction: random points, nearest-neighbour candidate edges
+// in random order, an edge is kept only if no edge of the straight-line
+// drawing ends up with more than k crossings
+Adj kPlanarGeometric(int n, int k, mt19937& rng)
+{
+    vector<pair<double,double>> p(n);
+    for (auto& q : p) {
+        q.first = unitReal(rng);
+        q.second = unitReal(rng);
+    }
+
+    const int nearest = 6;
+    vector<pair<int,int>> candidates;
+    for (int u = 0; u < n; u++) {
+        vector<pair<double,int>> byDistance;
+        for (int v = 0; v < n; v++)
+            if (v != u)
+                byDistance.push_back({hypot(p[u].first - p[v].first, p[u].second - p[v].second), v});
+        int take = min(nearest, (int)byDistance.size());
+        partial_sort(byDistance.begin(), byDistance.begin() + take, byDistance.end());
+        for (int i = 0; i < take; i++)
+            if (u < byDistance[i].second) candidates.push_back({u, byDistance[i].second});
+            else candidates.push_back({byDistance[i].second, u});
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+    shuffleVector(candidates, rng);
+
+    EdgeSet g(n);
+    vector<pair<int,int>> kept;
+    vector<int> crossings;
+    vector<int> hits;
+    for (const auto& c : candidates) {
+        hits.clear();
+        const auto& A = p[c.first];
+        const auto& B = p[c.second];
+        bool ok = true;
+        for (int e = 0; e < (int)kept.size() && ok; e++) {
+            int x = kept[e].first, y = kept[e].second;
+            if (x == c.first || x == c.second || y == c.first || y == c.second) continue;
+            if (CrossingCounter::segmentsIntersect(A.first, A.second, B.first, B.second,
+                                                   p[x].first, p[x].second, p[y].first, p[y].second)) {
+                hits.push_back(e);
+                ok = (int)hits.size() <= k && crossings[e] < k;
+            }
+        }
+        if (!ok) continue;
+
+        for (int e : hits) crossings[e]++;
+        kept.push_back(c);
+        crossings.push_back((int)hits.size());
+        g.add(c.first, c.second);
+    }
+    return g.adjacency();
+}
+
+// Barabasi-Albert preferential attachment, perNode edges per new vertex
+Adj scaleFree(int n, int perNode, mt19937& rng)
+{
+    EdgeSet g(n);
+    vector<int> endpoints;
+    int core = min(n, perNode + 1);
+    for (int u = 0; u < core; u++)
+        for (int v = u + 1; v < core; v++)
+            if (g.add(u, v)) { endpoints.push_back(u); endpoints.push_back(v); }
+
+    for (int v = core; v < n; v++) {
+        set<int> targets;
+        while ((int)targets.size() < min(perNode, v)) {
+            if (endpoints.empty()) targets.insert((int)uniformIndex(rng, v));
+            else targets.insert(endpoints[uniformIndex(rng, endpoints.size())]);
+        }
+        for (int t : targets)
+            if (g.add(v, t)) { endpoints.push_back(v); endpoints.push_back(t); }
+    }
+    return g.adjacency();
+}
+
+struct Family {
+    const char* name;
+    int maxVertices;    // generator cost bound
+    function<Adj(int n, mt19937& rng)> make;
+};
+
+vector<Family> families()
+{
+    return {
+        {"gnm",        1 << 30, [](int n, mt19937& rng) { return randomGnm(n, 2 * n, rng); }},
+        {"grid",       1 << 30, [](int n, mt19937&)     { return gridGraph(n); }},
+        {"triangulation", 1 << 30, [](int n, mt19937& rng) { return planarTriangulation(n, rng); }},
+        {"1-planar",   2000,    [](int n, mt19937& rng) { return kPlanarGeometric(n, 1, rng); }},
+        {"3-planar",   2000,    [](int n, mt19937& rng) { return kPlanarGeometric(n, 3, rng); }},
+        {"scale-free", 1 << 30, [](int n, mt19937& rng) { return scaleFree(n, 2, rng); }},
+    };
+}
+
+//------------------------------------------------------------
+// Output
+//------------------------------------------------------------
+
+struct Record {
+    string family;
+    int n = 0, m = 0;
+    unsigned seed = 0;
+    string stage;       // heuristic / counter / layout / render
+    string name;
+    double ms = 0;
+    long long crossings = -1;   // -1: not applicable
+    long long peakHeapBytes = 0;
+};
+
+class Writer {
+public:
+    Writer(FILE* out, bool csv) : out(out), csv(csv)
+    {
+        if (csv)
+            fprintf(out, "family,n,m,seed,stage,name,ms,crossings,peak_heap_bytes,max_rss_kb\n");
+    }
+
+    void write(const Record& r)
+    {
+        if (csv)
+            fprintf(out, "%s,%d,%d,%u,%s,%s,%.3f,%lld,%lld,%lld\n",
+                    r.family.c_str(), r.n, r.m, r.seed, r.stage.c_str(), r.name.c_str(),
+                    r.ms, r.crossings, r.peakHeapBytes, maxRssKb());
+        else
+            fprintf(out, "{\"family\":\"%s\",\"n\":%d,\"m\":%d,\"seed\":%u,\"stage\":\"%s\","
+                         "\"name\":\"%s\",\"ms\":%.3f,\"crossings\":%lld,"
+                         "\"peakHeapBytes\":%lld,\"maxRssKb\":%lld}\n",
+                    r.family.c_str(), r.n, r.m, r.seed, r.stage.c_str(), r.name.c_str(),
+                    r.ms, r.crossings, r.peakHeapBytes, maxRssKb());
+        fflush(out);
+    }
+
+private:
+    FILE* out;
+    bool csv;
+};
+
+//------------------------------------------------------------
+// One graph: every heuristic, the counters, computeLayout, rendering
+//------------------------------------------------------------
+
+struct Options {
+    vector<int> sizes = {14, 200, 1000, 5000};
+    vector<string> only;     // family filter
+    unsigned seed = 1;
+    bool csv = false;
+    bool render = true;
+    int frames = 10;
+    int bruteLimit = 5000;   // edges up to which the O(E^2) counter runs
+    const char* output = nullptr;
+};
+
+vector<pair<double,double>> place(const vector<int>& A, const vector<pair<double,double>>& coords)
+{
+    vector<pair<double,double>> L(A.size());
+    for (size_t v = 0; v < A.size(); v++) L[v] = coords[A[v]];
+    return L;
+}
+
+void benchGraph(const char* family, const Adj& adj, unsigned seed, const Options& opt, Writer& out)
+{
+    const int V = (int)adj.size();
+    const CsrGraph graph(adj, V);
+    const int E = graph.edgeCount();
+
+    Record base;
+    base.family = family;
+    base.n = V;
+    base.m = E;
+    base.seed = seed;
+
+    auto emit = [&](const char* stage, const string& name, const Measure& m, long long crossings) {
+        Record r = base;
+        r.stage = stage;
+        r.name = name;
+        r.ms = m.ms();
+        r.crossings = crossings;
+        r.peakHeapBytes = m.peakBytes();
+        out.write(r);
+    };
+
+    // Same preparation as computeLayout
+    const int r = grid_side(V);
+    const vector<pair<double,double>> coords = perturbed_grid(r, Solver::DefaultSeed);
+    const vector<int> spiral = spiralOrder(r);
+    const SolverControl control;
+
+    {
+        Measure m;
+        isPlanar(graph);
+        emit("heuristic", "planarity", m, -1);
+    }
+    {
+        Measure m;
+        vector<pair<double,double>> planar = planar_straight_line_drawing(graph);
+        double ms = m.ms();
+        long long peak = m.peakBytes();
+
+        Record rec = base;
+        rec.stage = "heuristic";
+        rec.name = "planar";
+        rec.ms = ms;
+        rec.crossings = planar.empty() ? -1 : CrossingCounter::count(planar, adj);
+        rec.peakHeapBytes = peak;
+        out.write(rec);
+    }
+
+    auto runHeuristic = [&](const char* name, const function<vector<int>()>& build) {
+        Measure m;
+        vector<int> A = build();
+        double ms = m.ms();
+        long long peak = m.peakBytes();
+        long long crossings = A.empty() ? -1 : CrossingCounter::count(place(A, coords), adj);
+
+        Record rec = base;
+        rec.stage = "heuristic";
+        rec.name = name;
+        rec.ms = ms;
+        rec.crossings = crossings;
+        rec.peakHeapBytes = peak;
+        out.write(rec);
+        return A;
+    };
+
+    runHeuristic("spiral", [&]() { return spiral_assignment(V, spiral); });
+    runHeuristic("degree", [&]() { return degree_greedy_assignment(V, graph, spiral); });
+    vector<int> bary = runHeuristic("barycentric", [&]() { return barycentric_assignment(V, graph, spiral); });
+    vector<int> refined = runHeuristic("refined", [&]() {
+        return distance_refinement_assignment(V, graph, bary, coords, target_distance(V, E), r,
+                                              Solver::DefaultSeed, control);
+    });
+    vector<int> bary2d = runHeuristic("barycentric2d", [&]() {
+        return barycentric_2d_assignment(V, graph, coords, spiral);
+    });
+    runHeuristic("refined2d", [&]() {
+        return distance_refinement_assignment(V, graph, bary2d, coords, target_distance(V, E), r,
+                                              Solver::DefaultSeed, control);
+    });
+    vector<int> multilevel = runHeuristic("multilevel", [&]() {
+        return multilevel_assignment(V, graph, coords, r, Solver::DefaultSeed, control);
+    });
+    runHeuristic("force", [&]() {
+        return force_directed_assignment(V, graph, coords, r, Solver::DefaultSeed, control);
+    });
+    runHeuristic("annealing", [&]() {
+        return annealing_assignment(V, graph, multilevel, coords, r, Solver::DefaultSeed,
+                                    AnnealingTimeLimitMs, control);
+    });
+    if (V <= ExactMaxVertices)
+        runHeuristic("exact", [&]() {
+            return branch_and_bound_layout(V, graph, coords, numeric_limits<int>::max(), control);
+        });
+
+    // Crossing counters on the refined drawing
+    const vector<pair<double,double>> drawing = place(refined, coords);
+    {
+        Measure m;
+        int c = CrossingCounter::count(drawing, adj);
+        emit("counter", "sweep", m, c);
+    }
+    {
+        Measure m;
+        EdgeIndex index;
+        index.build(drawing, graph.edges);
+        int c = index.countCrossings();
+        emit("counter", "grid", m, c);
+    }
+    if (E <= opt.bruteLimit) {
+        Measure m;
+        int c = CrossingCounter::countBruteForce(drawing, adj);
+        emit("counter", "brute", m, c);
+    }
+
+    // End to end, every selector entry
+    vector<pair<double,double>> best;
+    for (int h = 0; h < Solver::HeuristicCount; h++) {
+        Measure m;
+        auto result = Solver::computeLayout(V, E, adj, h);
+        double ms = m.ms();
+        long long peak = m.peakBytes();
+
+        Record rec = base;
+        rec.stage = "layout";
+        rec.name = Solver::heuristicName(h);
+        rec.ms = ms;
+        rec.crossings = CrossingCounter::count(result.second, adj);
+        rec.peakHeapBytes = peak;
+        out.write(rec);
+
+        if (h == Solver::BestHeuristic) best = result.second;
+    }
+
+    if (opt.render && !best.empty()) {
+        vector<pair<double,double>> scene(best.size());
+        for (size_t i = 0; i < best.size(); i++)
+            scene[i] = {best[i].first * 60.0 + 80.0, best[i].second * 60.0 + 80.0};
+
+        Measure m;
+        double frameMs = renderFrameMs(scene, adj, 1600, 1200, opt.frames);
+        Record rec = base;
+        rec.stage = "render";
+        rec.name = "paintEvent";
+        rec.ms = frameMs;
+        rec.peakHeapBytes = m.peakBytes();
+        out.write(rec);
+    }
+}
+
+vector<string> splitList(const char* text)
+{
+    vector<string> parts;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ','))
+        if (!item.empty()) parts.push_back(item);
+    return parts;
+}
+
+void usage()
+{
+    fprintf(stderr,
+            "usage: clarity-bench [options]\n"
+            "  --sizes a,b,...     vertex counts (default 14,200,1000,5000)\n"
+            "  --families a,b,...  gnm, grid, triangulation, 1-planar, 3-planar, scale-free\n"
+            "  --seed n            generator seed (default 1)\n"
+            "  --quick             sizes 12,100,500 and 3 frames\n"
+            "  --frames n          paintEvent repetitions (default 10)\n"
+            "  --no-render         skip the GraphWidget measurement\n"
+            "  --csv               CSV instead of JSON lines\n"
+            "  -o file             write to file instead of stdout\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(); exit(2); }
+            return argv[++i];
+        };
+        if (!strcmp(argv[i], "--sizes")) {
+            opt.sizes.clear();
+            for (const string& s : splitList(next())) opt.sizes.push_back(max(1, atoi(s.c_str())));
+        } else if (!strcmp(argv[i], "--families")) {
+            opt.only = splitList(next());
+        } else if (!strcmp(argv[i], "--seed")) {
+            opt.seed = (unsigned)strtoul(next(), nullptr, 10);
+        } else if (!strcmp(argv[i], "--quick")) {
+            opt.sizes = {12, 100, 500};
+            opt.frames = 3;
+        } else if (!strcmp(argv[i], "--frames")) {
+            opt.frames = max(1, atoi(next()));
+        } else if (!strcmp(argv[i], "--no-render")) {
+            opt.render = false;
+        } else if (!strcmp(argv[i], "--csv")) {
+            opt.csv = true;
+        } else if (!strcmp(argv[i], "-o")) {
+            opt.output = next();
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    FILE* out = stdout;
+    if (opt.output && !(out = fopen(opt.output, "w"))) {
+        fprintf(stderr, "cannot write %s\n", opt.output);
+        return 1;
+    }
+
+    Solver::setVerbose(false);
+    Writer writer(out, opt.csv);
+
+    for (const Family& family : families()) {
+        if (!opt.only.empty() && find(opt.only.begin(), opt.only.end(), family.name) == opt.only.end())
+            continue;
+        for (int n : opt.sizes) {
+            if (n > family.maxVertices) continue;
+            // Same graph for a given (seed, family, n) on every machine
+            unsigned seed = opt.seed * 1000003u + (unsigned)n;
+            mt19937 rng(seed);
+            Adj adj = family.make(n, rng);
+            benchGraph(family.name, adj, seed, opt, writer);
+        }
+    }
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
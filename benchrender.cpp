@@ -0,0 +1,71 @@
+#include "benchrender.h"
+#include "graphwidget.h"
+
+#include <QApplication>
+#include <QImage>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+static void ensureApplication()
+{
+    if (QApplication::instance()) return;
+
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+#ifdef CLARITY_OPENGL
+    QSurfaceFormat::setDefaultFormat(GraphGLRenderer::requiredFormat());
+#endif
+
+    static int argc = 1;
+    static char name[] = "clarity-bench";
+    static char *argv[] = {name, nullptr};
+    static QApplication app(argc, argv);
+}
+
+double renderFrameMs(
+    const vector<pair<double, double>>& scenePositions,
+    const vector<vector<int>>& adj,
+    int width, int height, int frames)
+{
+    ensureApplication();
+    if (frames < 1) frames = 1;
+
+    vector<NodeInfo> nodes(scenePositions.size());
+    double minX = 0, minY = 0, maxX = 1, maxY = 1;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        NodeInfo &N = nodes[i];
+        N.x = scenePositions[i].first;
+        N.y = scenePositions[i].second;
+        N.name = "Node " + QString::number(i);
+        N.updateColors();
+
+        if (i == 0 || N.x < minX) minX = N.x;
+        if (i == 0 || N.x > maxX) maxX = N.x;
+        if (i == 0 || N.y < minY) minY = N.y;
+        if (i == 0 || N.y > maxY) maxY = N.y;
+    }
+
+    GraphWidget widget;
+    widget.setNodes(nodes);
+    widget.setAdjacency(adj);
+    widget.resize(width, height);
+
+    // Fit the whole drawing, with a margin for node labels
+    const double margin = 40;
+    widget.zoom = min((width - 2 * margin) / max(1.0, maxX - minX),
+                      (height - 2 * margin) / max(1.0, maxY - minY));
+    widget.offsetX = margin - minX * widget.zoom;
+    widget.offsetY = margin - minY * widget.zoom;
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    widget.render(&image);   // warm-up: fonts, glyph caches
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++)
+        widget.render(&image);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return ms / frames;
+}
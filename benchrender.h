@@ -0,0 +1,12 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// Offscreen rendering of GraphWidget for the benchmark tool. The widget is
+// zoomed to fit the drawing and painted into a QImage of the given size;
+// returns the mean time of one paintEvent in milliseconds.
+// Uses the "offscreen" platform unless QT_QPA_PLATFORM is already set.
+double renderFrameMs(
+    const std::vector<std::pair<double, double>>& scenePositions,
+    const std::vector<std::vector<int>>& adj,
+    int width, int height, int frames);
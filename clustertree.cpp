@@ -0,0 +1,133 @@
+#include "clustertree.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+
+// Spreads the low 16 bits of x to the even bits
+uint32_t spread(uint32_t x)
+{
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+} // namespace
+
+void ClusterTree::build(const vector<pair<double,double>>& positions,
+                        const vector<pair<int,int>>& edges)
+{
+    const int n = (int)positions.size();
+    edgeList = edges;
+    levels.clear();
+
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int v = 0; v < n; v++) {
+        if (v == 0 || positions[v].first < minX)  minX = positions[v].first;
+        if (v == 0 || positions[v].first > maxX)  maxX = positions[v].first;
+        if (v == 0 || positions[v].second < minY) minY = positions[v].second;
+        if (v == 0 || positions[v].second > maxY) maxY = positions[v].second;
+    }
+    originX = minX;
+    originY = minY;
+    side = max(maxX - minX, maxY - minY);
+    if (!(side > 0)) side = 1;
+
+    // A few levels finer than one node per cell on average; deeper levels
+    // would only separate nodes that overlap on screen anyway
+    bits = 4;
+    while (bits < 16 && (1 << (2 * (bits - 4))) < n) bits++;
+
+    const double scale = (1 << bits) / side;
+    const uint32_t maxCell = (1u << bits) - 1;
+    vector<uint32_t> code(n);
+    for (int v = 0; v < n; v++) {
+        double fx = floor((positions[v].first - originX) * scale);
+        double fy = floor((positions[v].second - originY) * scale);
+        uint32_t cx = fx > 0 ? (uint32_t)min<double>(fx, maxCell) : 0;
+        uint32_t cy = fy > 0 ? (uint32_t)min<double>(fy, maxCell) : 0;
+        code[v] = spread(cx) | (spread(cy) << 1);
+    }
+
+    order.resize(n);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return code[a] != code[b] ? code[a] < code[b] : a < b;
+    });
+    codes.resize(n);
+    for (int i = 0; i < n; i++) codes[i] = code[order[i]];
+
+    for (int level = 0; level <= bits; level++) {
+        const int shift = 2 * (bits - level);
+        Level L;
+        for (int i = 0; i < n; ) {
+            int j = i;
+            uint32_t cell = shift < 32 ? codes[i] >> shift : 0;
+            double sx = 0, sy = 0;
+            int first = order[i];
+            for (; j < n && (shift < 32 ? codes[j] >> shift : 0) == cell; j++) {
+                sx += positions[order[j]].first;
+                sy += positions[order[j]].second;
+                first = min(first, order[j]);
+            }
+            L.begin.push_back(i);
+            L.clusters.push_back({sx / (j - i), sy / (j - i), j - i, first});
+            i = j;
+        }
+        L.begin.push_back(n);
+        const bool singletons = (int)L.clusters.size() == n;
+        levels.push_back(std::move(L));
+        if (singletons) break;
+    }
+}
+
+double ClusterTree::cellSize(int level) const
+{
+    return side / (double)(1u << level);
+}
+
+int ClusterTree::levelFor(double size) const
+{
+    for (int level = 0; level < depth(); level++)
+        if (cellSize(level) <= size) return level;
+    return depth();
+}
+
+const vector<ClusterTree::Link>& ClusterTree::links(int level)
+{
+    Level& L = levels[level];
+    if (L.linked) return L.links;
+
+    const int n = nodeCount();
+    vector<int> clusterOf(n);
+    for (int c = 0; c < (int)L.clusters.size(); c++)
+        for (int i = L.begin[c]; i < L.begin[c + 1]; i++)
+            clusterOf[order[i]] = c;
+
+    vector<uint64_t> packed;
+    packed.reserve(edgeList.size());
+    for (const auto& e : edgeList) {
+        if (e.first < 0 || e.second < 0 || e.first >= n || e.second >= n) continue;
+        int a = clusterOf[e.first], b = clusterOf[e.second];
+        if (a == b) continue;
+        if (a > b) swap(a, b);
+        packed.push_back(((uint64_t)a << 32) | (uint32_t)b);
+    }
+    sort(packed.begin(), packed.end());
+
+    L.links.clear();
+    for (size_t i = 0; i < packed.size(); ) {
+        size_t j = i;
+        while (j < packed.size() && packed[j] == packed[i]) j++;
+        L.links.push_back({(int)(packed[i] >> 32), (int)(uint32_t)packed[i], (int)(j - i)});
+        i = j;
+    }
+    L.linked = true;
+    return L.links;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Quadtree hierarchy of a drawing for level-of-detail rendering. Level L
+// splits the bounding square into 2^L x 2^L cells; the nodes of one cell
+// form a cluster. All levels come from a single Morton-order sort, so the
+// clusters of a level are runs of that order. Links between the clusters
+// of a level are aggregated on first use and kept until the next build().
+class ClusterTree {
+public:
+    struct Cluster {
+        double x, y;     // centroid
+        int count;
+        int first;       // smallest node id, stands for the cluster
+    };
+
+    struct Link {
+        int a, b;        // clusters, a < b
+        int weight;      // edges between them
+    };
+
+    void build(const std::vector<std::pair<double, double>>& positions,
+               const std::vector<std::pair<int, int>>& edges);
+
+    int nodeCount() const { return (int)order.size(); }
+    int depth() const { return (int)levels.size() - 1; }
+
+    double cellSize(int level) const;
+
+    // Coarsest level whose cells are no larger than size, or depth()
+    int levelFor(double size) const;
+
+    const std::vector<Cluster>& clusters(int level) const { return levels[level].clusters; }
+    const std::vector<Link>& links(int level);
+
+private:
+    struct Level {
+        std::vector<Cluster> clusters;
+        std::vector<int> begin;          // cluster -> first index into order
+        std::vector<Link> links;
+        bool linked = false;
+    };
+
+    double originX = 0, originY = 0, side = 1;
+    int bits = 0;                         // cells per side of the finest level: 2^bits
+    std::vector<int> order;               // nodes by Morton code
+    std::vector<std::uint32_t> codes;     // Morton code per position in order
+    std::vector<std::pair<int, int>> edgeList;
+    std::vector<Level> levels;
+};
@@ -0,0 +1,68 @@
+#include "components.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+vector<vector<int>> connected_components(const CsrGraph& g)
+{
+    const int n = g.vertexCount();
+    vector<int> seen(n, 0);
+    vector<vector<int>> components;
+    vector<int> stack;
+
+    for (int s = 0; s < n; s++) {
+        if (seen[s]) continue;
+        components.emplace_back();
+        vector<int>& members = components.back();
+
+        seen[s] = 1;
+        stack.push_back(s);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            members.push_back(v);
+            for (int w : g.neighbours(v))
+                if (!seen[w]) {
+                    seen[w] = 1;
+                    stack.push_back(w);
+                }
+        }
+        sort(members.begin(), members.end());
+    }
+    return components;
+}
+
+vector<pair<double,double>> pack_rectangles(const vector<pair<double,double>>& sizes, double gap)
+{
+    const int n = (int)sizes.size();
+    vector<pair<double,double>> corner(n);
+    if (n == 0) return corner;
+
+    // Target row width: the side of a square holding all the area
+    double area = 0, widest = 0;
+    for (const auto& s : sizes) {
+        area += (s.first + gap) * (s.second + gap);
+        widest = max(widest, s.first);
+    }
+    const double rowWidth = max(widest, sqrt(area));
+
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&](int a, int b) { return sizes[a].second > sizes[b].second; });
+
+    double x = 0, y = 0, rowHeight = 0;
+    for (int i : order) {
+        if (x > 0 && x + sizes[i].first > rowWidth) {
+            x = 0;
+            y += rowHeight + gap;
+            rowHeight = 0;
+        }
+        corner[i] = {x, y};
+        x += sizes[i].first + gap;
+        rowHeight = max(rowHeight, sizes[i].second);
+    }
+    return corner;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "csrgraph.h"
+
+// Vertex lists of the connected components, each sorted, ordered by their
+// smallest vertex
+std::vector<std::vector<int>> connected_components(const CsrGraph& g);
+
+// Shelf packing, tallest first: rectangles of the given (width, height) are
+// laid out in rows about as wide as the packing is tall, `gap` apart.
+// Returns the lower-left corner of every rectangle.
+std::vector<std::pair<double, double>> pack_rectangles(
+    const std::vector<std::pair<double, double>>& sizes,
+    double gap);
@@ -0,0 +1,659 @@
+#include "crossings.h"
+#include <vector>
+#include <cmath>
+#include <set>
+#include <queue>
+#include <limits>
+#include <cstdint>
+#include <unordered_set>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+bool CrossingCounter::segmentsIntersect(
+    double Ax, double Ay, double Bx, double By,
+    double Cx, double Cy, double Dx, double Dy)
+{
+    auto ccw = [](double Ax, double Ay, double Bx, double By, double Cx, double Cy){
+        return (Cy - Ay) * (Bx - Ax) > (By - Ay) * (Cx - Ax);
+    };
+
+    // The strict test is not symmetric for collinear touches. Put both
+    // segments in a canonical order so the answer only depends on the pair,
+    // whichever edge a caller passes first.
+    auto less = [](double Px, double Py, double Qx, double Qy) {
+        return Px < Qx || (Px == Qx && Py < Qy);
+    };
+    if (less(Bx,By, Ax,Ay)) { swap(Ax, Bx); swap(Ay, By); }
+    if (less(Dx,Dy, Cx,Cy)) { swap(Cx, Dx); swap(Cy, Dy); }
+    if (less(Cx,Cy, Ax,Ay) || (Cx == Ax && Cy == Ay && less(Dx,Dy, Bx,By))) {
+        swap(Ax, Cx); swap(Ay, Cy);
+        swap(Bx, Dx); swap(By, Dy);
+    }
+
+    return ccw(Ax,Ay,Cx,Cy,Dx,Dy) != ccw(Bx,By,Cx,Cy,Dx,Dy) &&
+           ccw(Ax,Ay,Bx,By,Cx,Cy) != ccw(Ax,Ay,Bx,By,Dx,Dy);
+}
+
+vector<pair<int,int>> CrossingCounter::edgeList(
+    const vector<vector<int>>& adj, int n)
+{
+    vector<pair<int,int>> edges;
+    for (int u = 0; u < n; u++)
+        for (int v : adj[u])
+            if (u < v && v < n)
+                edges.push_back({u, v});
+    return edges;
+}
+
+int CrossingCounter::countBruteForce(
+    const vector<pair<double,double>>& pos,
+    const vector<vector<int>>& adj,
+    vector<int>* perEdge)
+{
+    int count = 0;
+    int n = min(adj.size(), pos.size());
+    vector<pair<int,int>> edges = edgeList(adj, n);
+    int m = edges.size();
+
+    if (perEdge) perEdge->assign(m, 0);
+
+    for (int i = 0; i < m; i++) {
+        int u = edges[i].first, v = edges[i].second;
+        double Ax = pos[u].first,  Ay = pos[u].second;
+        double Bx = pos[v].first,  By = pos[v].second;
+
+        for (int j = i + 1; j < m; j++) {
+            int x = edges[j].first, y = edges[j].second;
+            if (u == x || u == y || v == x || v == y) continue;
+
+            double Cx = pos[x].first,  Cy = pos[x].second;
+            double Dx = pos[y].first,  Dy = pos[y].second;
+
+            if (segmentsIntersect(Ax,Ay,Bx,By, Cx,Cy,Dx,Dy)) {
+                count++;
+                if (perEdge) { (*perEdge)[i]++; (*perEdge)[j]++; }
+            }
+        }
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------
+// Bentley-Ottmann sweep
+//------------------------------------------------------------
+//
+// The sweep runs over slightly rotated coordinates so that axis aligned
+// edges (very common on the solver grid and for hand placed nodes) are not
+// vertical to the sweep line. Crossings are still decided with
+// segmentsIntersect() on the original coordinates, and every crossing pair is
+// counted once, the first time the two segments become neighbours in the
+// status structure.
+//
+// A sweep is only exact in general position. When an event point lies on a
+// neighbouring segment (T-junctions, collinear overlaps, three edges through
+// one point) the orientation test itself decides ties by rounding, so the
+// pairwise scan is used instead to keep the count identical. The scan is
+// also faster once crossings make up a sizeable share of all edge pairs, so
+// the sweep gives up when K passes that point.
+
+namespace {
+
+struct SweepSegment {
+    double x1, y1, x2, y2;   // rotated, (x1,y1) is the left endpoint
+    double slope;
+    int u, v;                // original endpoints
+    int lu, lv;              // endpoint locations (coincident vertices merged)
+    int left, right;         // original endpoint at (x1,y1) / (x2,y2)
+};
+
+enum EventType { EV_END = 0, EV_CROSS = 1, EV_START = 2 };
+
+struct SweepEvent {
+    double x, y;
+    int type;
+    int a, b;
+
+    bool operator>(const SweepEvent& o) const {
+        if (x != o.x) return x > o.x;
+        if (y != o.y) return y > o.y;
+        return type > o.type;
+    }
+};
+
+struct SweepState {
+    const vector<SweepSegment>* segs = nullptr;
+    double x = 0, y = 0;
+
+    double yAt(int s) const {
+        const SweepSegment& S = (*segs)[s];
+        if (S.x1 == S.x2) return min(max(y, S.y1), S.y2);
+        if (x <= S.x1) return S.y1;
+        if (x >= S.x2) return S.y2;
+        return S.y1 + (x - S.x1) * S.slope;
+    }
+};
+
+struct StatusNode {
+    mutable int id;   // swapped in place when two neighbours cross
+};
+
+struct StatusLess {
+    const SweepState* st;
+
+    bool operator()(const StatusNode& a, const StatusNode& b) const {
+        if (a.id == b.id) return false;
+        double ya = st->yAt(a.id), yb = st->yAt(b.id);
+        if (ya != yb) return ya < yb;
+        double sa = (*st->segs)[a.id].slope, sb = (*st->segs)[b.id].slope;
+        if (sa != sb) return sa < sb;
+        return a.id < b.id;
+    }
+};
+
+// True when P is (numerically) on segment AB
+bool nearSegment(const pair<double,double>& P,
+                 const pair<double,double>& A,
+                 const pair<double,double>& B)
+{
+    double bx = B.first - A.first, by = B.second - A.second;
+    double px = P.first - A.first, py = P.second - A.second;
+    double len2 = bx * bx + by * by;
+    double cross = bx * py - by * px;
+    double dot = bx * px + by * py;
+    double tol = 1e-9 * (len2 + px * px + py * py);
+    return fabs(cross) <= tol && dot >= -tol && dot <= len2 + tol;
+}
+
+} // namespace
+
+int CrossingCounter::count(
+    const vector<pair<double,double>>& pos,
+    const vector<vector<int>>& adj,
+    vector<int>* perEdge)
+{
+    const int n = min(adj.size(), pos.size());
+    const vector<pair<int,int>> edges = edgeList(adj, n);
+
+    if (perEdge) perEdge->assign(edges.size(), 0);
+
+    // Small irrational-ish rotation, see comment above
+    const double rc = cos(0.0137), rs = sin(0.0137);
+
+    // Distinct vertices drawn on the same point (e.g. a freshly added node
+    // sitting on its anchor) share a location. Edges meeting at a location
+    // are settled directly with segmentsIntersect() and skipped by the sweep.
+    vector<int> loc(n);
+    {
+        map<pair<double,double>, int> ids;
+        for (int i = 0; i < n; i++)
+            loc[i] = ids.emplace(pos[i], (int)ids.size()).first->second;
+    }
+
+    vector<SweepSegment> segs;
+    vector<vector<int>> segEdges;   // edge ids drawn on each segment
+    map<pair<int,int>, int> segAt;
+    for (int id = 0; id < (int)edges.size(); id++) {
+        int u = edges[id].first, v = edges[id].second;
+        // zero length edges never satisfy segmentsIntersect()
+        if (pos[u] == pos[v]) continue;
+
+        // Overlapping copies of one segment are swept once
+        pair<int,int> key(min(loc[u], loc[v]), max(loc[u], loc[v]));
+        auto found = segAt.find(key);
+        if (found != segAt.end()) {
+            segEdges[found->second].push_back(id);
+            continue;
+        }
+        segAt[key] = segs.size();
+        segEdges.push_back({id});
+
+        double ax = pos[u].first * rc + pos[u].second * rs;
+        double ay = pos[u].second * rc - pos[u].first * rs;
+        double bx = pos[v].first * rc + pos[v].second * rs;
+        double by = pos[v].second * rc - pos[v].first * rs;
+
+        SweepSegment S;
+        if (ax < bx || (ax == bx && ay < by)) {
+            S.x1 = ax; S.y1 = ay; S.x2 = bx; S.y2 = by;
+            S.left = u; S.right = v;
+        } else {
+            S.x1 = bx; S.y1 = by; S.x2 = ax; S.y2 = ay;
+            S.left = v; S.right = u;
+        }
+        S.slope = (S.x1 == S.x2) ? numeric_limits<double>::infinity()
+                                 : (S.y2 - S.y1) / (S.x2 - S.x1);
+        S.u = u;
+        S.v = v;
+        S.lu = loc[u];
+        S.lv = loc[v];
+        segs.push_back(S);
+    }
+
+    const int m = segs.size();
+    if (m < 2) return 0;
+
+    auto crosses = [&](const SweepSegment& A, const SweepSegment& B) {
+        if (A.u == B.u || A.u == B.v || A.v == B.u || A.v == B.v) return false;
+        const auto& pa = pos[A.u]; const auto& pb = pos[A.v];
+        const auto& pc = pos[B.u]; const auto& pd = pos[B.v];
+        return segmentsIntersect(pa.first, pa.second, pb.first, pb.second,
+                                 pc.first, pc.second, pd.first, pd.second);
+    };
+
+    int count = 0;
+
+    auto addPair = [&](int e, int f) {
+        count++;
+        if (perEdge) { (*perEdge)[e]++; (*perEdge)[f]++; }
+    };
+
+    // Pairs meeting at a shared location, checked edge by edge
+    {
+        vector<vector<int>> atLoc(n);
+        for (int id = 0; id < (int)edges.size(); id++) {
+            int u = edges[id].first, v = edges[id].second;
+            if (pos[u] == pos[v]) continue;
+            atLoc[loc[u]].push_back(id);
+            atLoc[loc[v]].push_back(id);
+        }
+        for (int l = 0; l < n; l++) {
+            const auto& L = atLoc[l];
+            for (size_t i = 0; i < L.size(); i++)
+                for (size_t j = i + 1; j < L.size(); j++) {
+                    int a = edges[L[i]].first, b = edges[L[i]].second;
+                    int c = edges[L[j]].first, d = edges[L[j]].second;
+                    if (a == c || a == d || b == c || b == d) continue;
+                    // a pair meeting at both ends is listed twice, count it once
+                    bool both = (loc[a] == loc[c] && loc[b] == loc[d]) ||
+                                (loc[a] == loc[d] && loc[b] == loc[c]);
+                    if (both && l != min(loc[a], loc[b])) continue;
+                    if (segmentsIntersect(pos[a].first, pos[a].second, pos[b].first, pos[b].second,
+                                          pos[c].first, pos[c].second, pos[d].first, pos[d].second))
+                        addPair(L[i], L[j]);
+                }
+        }
+    }
+
+    priority_queue<SweepEvent, vector<SweepEvent>, greater<SweepEvent>> events;
+    for (int i = 0; i < m; i++) {
+        events.push({segs[i].x1, segs[i].y1, EV_START, i, -1});
+        events.push({segs[i].x2, segs[i].y2, EV_END,   i, -1});
+    }
+
+    SweepState st;
+    st.segs = &segs;
+
+    using Status = set<StatusNode, StatusLess>;
+    Status status(StatusLess{&st});
+    vector<Status::iterator> where(m, status.end());
+
+    unordered_set<uint64_t> seen;
+    bool fallback = false;
+    const uint64_t denseLimit = (uint64_t)m * (uint64_t)m / 512 + 1024;
+
+    auto check = [&](int a, int b) {
+        const SweepSegment& A = segs[a];
+        const SweepSegment& B = segs[b];
+        if (A.lu == B.lu || A.lu == B.lv || A.lv == B.lu || A.lv == B.lv) return;
+        if (!crosses(A, B)) return;
+
+        uint64_t key = (uint64_t)min(a, b) * (uint64_t)m + (uint64_t)max(a, b);
+        if (!seen.insert(key).second) return;
+        for (int e : segEdges[a])
+            for (int f : segEdges[b])
+                addPair(e, f);
+
+        double rx = A.x2 - A.x1, ry = A.y2 - A.y1;
+        double sx = B.x2 - B.x1, sy = B.y2 - B.y1;
+        double den = rx * sy - ry * sx;
+        double ix = st.x, iy = st.y;
+        if (den != 0) {
+            double t = ((B.x1 - A.x1) * sy - (B.y1 - A.y1) * sx) / den;
+            ix = A.x1 + t * rx;
+            iy = A.y1 + t * ry;
+        }
+        if (ix < st.x || (ix == st.x && iy < st.y)) { ix = st.x; iy = st.y; }
+        events.push({ix, iy, EV_CROSS, a, b});
+    };
+
+    // Event point p of segment s: the first segments above and below that do
+    // not end at p must keep clear of it
+    auto touchesNeighbours = [&](Status::iterator it, int vertex) {
+        const auto& P = pos[vertex];
+        int l = loc[vertex];
+        for (auto up = next(it); up != status.end(); ++up) {
+            const SweepSegment& S = segs[up->id];
+            if (S.lu == l || S.lv == l) continue;
+            if (nearSegment(P, pos[S.u], pos[S.v])) return true;
+            break;
+        }
+        for (auto dn = it; dn != status.begin(); ) {
+            --dn;
+            const SweepSegment& S = segs[dn->id];
+            if (S.lu == l || S.lv == l) continue;
+            if (nearSegment(P, pos[S.u], pos[S.v])) return true;
+            break;
+        }
+        return false;
+    };
+
+    while (!events.empty() && !fallback) {
+        if (seen.size() > denseLimit) { fallback = true; break; }
+
+        SweepEvent e = events.top();
+        events.pop();
+        st.x = e.x;
+        st.y = e.y;
+
+        if (e.type == EV_START) {
+            auto it = status.insert(StatusNode{e.a}).first;
+            where[e.a] = it;
+            if (touchesNeighbours(it, segs[e.a].left)) { fallback = true; break; }
+            if (it != status.begin()) check(prev(it)->id, e.a);
+            auto nx = next(it);
+            if (nx != status.end()) check(e.a, nx->id);
+        }
+        else if (e.type == EV_END) {
+            auto it = where[e.a];
+            if (touchesNeighbours(it, segs[e.a].right)) { fallback = true; break; }
+            auto nx = next(it);
+            bool hasBelow = it != status.begin();
+            int below = hasBelow ? prev(it)->id : -1;
+            status.erase(it);
+            where[e.a] = status.end();
+            if (hasBelow && nx != status.end()) check(below, nx->id);
+        }
+        else {
+            auto ia = where[e.a], ib = where[e.b];
+            if (ia == status.end() || ib == status.end()) continue;
+
+            Status::iterator lo, hi;
+            if (next(ia) == ib)      { lo = ia; hi = ib; }
+            else if (next(ib) == ia) { lo = ib; hi = ia; }
+            else { fallback = true; break; }   // several segments through one point
+
+            // swap the two neighbours in place, the tree shape stays valid
+            int loId = lo->id, hiId = hi->id;
+            lo->id = hiId;
+            hi->id = loId;
+            where[hiId] = lo;
+            where[loId] = hi;
+
+            if (lo != status.begin()) check(prev(lo)->id, lo->id);
+            auto nx = next(hi);
+            if (nx != status.end()) check(hi->id, nx->id);
+        }
+    }
+
+    if (fallback)
+        return countBruteForce(pos, adj, perEdge);
+
+    return count;
+}
+
+//------------------------------------------------------------
+// Edge grid index
+//------------------------------------------------------------
+
+void EdgeIndex::build(
+    const vector<pair<double,double>>& positions,
+    const vector<vector<int>>& adj,
+    double cellSize)
+{
+    int n = min(adj.size(), positions.size());
+    build(vector<pair<double,double>>(positions.begin(), positions.begin() + n),
+          CrossingCounter::edgeList(adj, n), cellSize);
+}
+
+void EdgeIndex::build(
+    const vector<pair<double,double>>& positions,
+    const vector<pair<int,int>>& edgePairs,
+    double cellSize)
+{
+    int n = positions.size();
+    pos = positions;
+    edges.clear();
+    for (const auto& e : edgePairs)
+        if (e.first >= 0 && e.second < n && e.first < e.second)
+            edges.push_back(e);
+    int m = edges.size();
+
+    incident.assign(n, {});
+    for (int id = 0; id < m; id++) {
+        incident[edges[id].first].push_back(id);
+        incident[edges[id].second].push_back(id);
+    }
+
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int v = 0; v < n; v++) {
+        if (v == 0 || pos[v].first < minX)  minX = pos[v].first;
+        if (v == 0 || pos[v].first > maxX)  maxX = pos[v].first;
+        if (v == 0 || pos[v].second < minY) minY = pos[v].second;
+        if (v == 0 || pos[v].second > maxY) maxY = pos[v].second;
+    }
+    double W = maxX - minX, H = maxY - minY;
+
+    // Default: about one cell per edge, never smaller than a typical edge
+    if (cellSize <= 0) {
+        double meanLength = 0;
+        for (const auto& e : edges)
+            meanLength += hypot(pos[e.first].first - pos[e.second].first,
+                                pos[e.first].second - pos[e.second].second);
+        if (m > 0) meanLength /= m;
+        cellSize = max(meanLength, sqrt(W * H / max(1, m)));
+    }
+    if (!(cellSize > 0)) cellSize = max(1.0, max(W, H));
+    while ((W / cellSize + 1) * (H / cellSize + 1) > 4.0 * m + 64)
+        cellSize *= 1.5;
+
+    cell = cellSize;
+    originX = minX;
+    originY = minY;
+    gridW = (int)(W / cell) + 1;
+    gridH = (int)(H / cell) + 1;
+
+    cells.assign((size_t)gridW * gridH, {});
+    ranges.assign(m, CellRange{0, 0, 0, 0});
+    for (int id = 0; id < m; id++) insertEdge(id);
+}
+
+int EdgeIndex::cellX(double x) const
+{
+    double c = floor((x - originX) / cell);
+    if (!(c > 0)) return 0;
+    return c >= gridW - 1 ? gridW - 1 : (int)c;
+}
+
+int EdgeIndex::cellY(double y) const
+{
+    double c = floor((y - originY) / cell);
+    if (!(c > 0)) return 0;
+    return c >= gridH - 1 ? gridH - 1 : (int)c;
+}
+
+EdgeIndex::CellRange EdgeIndex::rangeOf(double Ax, double Ay, double Bx, double By) const
+{
+    return CellRange{cellX(min(Ax, Bx)), cellY(min(Ay, By)),
+                     cellX(max(Ax, Bx)), cellY(max(Ay, By))};
+}
+
+void EdgeIndex::insertEdge(int e)
+{
+    const auto& A = pos[edges[e].first];
+    const auto& B = pos[edges[e].second];
+    CellRange r = rangeOf(A.first, A.second, B.first, B.second);
+    ranges[e] = r;
+    for (int y = r.y0; y <= r.y1; y++)
+        for (int x = r.x0; x <= r.x1; x++)
+            cells[(size_t)y * gridW + x].push_back(e);
+}
+
+void EdgeIndex::removeEdge(int e)
+{
+    const CellRange& r = ranges[e];
+    for (int y = r.y0; y <= r.y1; y++)
+        for (int x = r.x0; x <= r.x1; x++) {
+            vector<int>& list = cells[(size_t)y * gridW + x];
+            auto it = find(list.begin(), list.end(), e);
+            if (it != list.end()) {
+                *it = list.back();
+                list.pop_back();
+            }
+        }
+}
+
+void EdgeIndex::edgesInBox(double x0, double y0, double x1, double y1, vector<int>& out) const
+{
+    CellRange q = rangeOf(x0, y0, x1, y1);
+
+    for (int cy = q.y0; cy <= q.y1; cy++)
+        for (int cx = q.x0; cx <= q.x1; cx++)
+            for (int f : cells[(size_t)cy * gridW + cx]) {
+                // Reported from the first cell it shares with the box only
+                const CellRange& rf = ranges[f];
+                if (max(q.x0, rf.x0) != cx || max(q.y0, rf.y0) != cy) continue;
+
+                const auto& C = pos[edges[f].first];
+                const auto& D = pos[edges[f].second];
+                if (max(C.first, D.first) < x0 || min(C.first, D.first) > x1 ||
+                    max(C.second, D.second) < y0 || min(C.second, D.second) > y1)
+                    continue;
+                out.push_back(f);
+            }
+}
+
+void EdgeIndex::moveVertex(int v, double x, double y)
+{
+    if (v < 0 || v >= (int)pos.size()) return;
+
+    for (int e : incident[v]) removeEdge(e);
+    pos[v] = {x, y};
+    for (int e : incident[v]) insertEdge(e);
+}
+
+int EdgeIndex::countCrossings(vector<int>* perEdge, const function<bool()>& stop) const
+{
+    int count = 0;
+    if (perEdge) perEdge->assign(edges.size(), 0);
+
+    // stop is polled about every StopInterval pair tests; long edges can
+    // pile most of the drawing into a few cells
+    const long long StopInterval = 1 << 16;
+    long long untilStop = 0;
+
+    for (int cy = 0; cy < gridH; cy++) {
+        for (int cx = 0; cx < gridW; cx++) {
+            const vector<int>& list = cells[(size_t)cy * gridW + cx];
+            for (size_t i = 0; i < list.size(); i++) {
+                if (stop && (untilStop -= (long long)(list.size() - i)) <= 0) {
+                    if (stop()) return -1;
+                    untilStop = StopInterval;
+                }
+                int e = list[i];
+                const CellRange& re = ranges[e];
+                int a = edges[e].first, b = edges[e].second;
+                const auto& A = pos[a];
+                const auto& B = pos[b];
+
+                for (size_t j = i + 1; j < list.size(); j++) {
+                    int f = list[j];
+                    const CellRange& rf = ranges[f];
+                    if (max(re.x0, rf.x0) != cx || max(re.y0, rf.y0) != cy) continue;
+
+                    int c = edges[f].first, d = edges[f].second;
+                    if (a == c || a == d || b == c || b == d) continue;
+
+                    const auto& C = pos[c];
+                    const auto& D = pos[d];
+                    if (CrossingCounter::segmentsIntersect(A.first, A.second, B.first, B.second,
+                                                           C.first, C.second, D.first, D.second)) {
+                        count++;
+                        if (perEdge) { (*perEdge)[e]++; (*perEdge)[f]++; }
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+int EdgeIndex::segmentCrossings(double Ax, double Ay, double Bx, double By,
+                                int a, int b, vector<int>* hits) const
+{
+    int count = 0;
+    CellRange q = rangeOf(Ax, Ay, Bx, By);
+
+    for (int cy = q.y0; cy <= q.y1; cy++)
+        for (int cx = q.x0; cx <= q.x1; cx++)
+            for (int f : cells[(size_t)cy * gridW + cx]) {
+                const CellRange& rf = ranges[f];
+                if (max(q.x0, rf.x0) != cx || max(q.y0, rf.y0) != cy) continue;
+
+                int c = edges[f].first, d = edges[f].second;
+                if (a == c || a == d || b == c || b == d) continue;
+
+                const auto& C = pos[c];
+                const auto& D = pos[d];
+                if (CrossingCounter::segmentsIntersect(Ax, Ay, Bx, By,
+                                                       C.first, C.second, D.first, D.second)) {
+                    count++;
+                    if (hits) hits->push_back(f);
+                }
+            }
+
+    return count;
+}
+
+//------------------------------------------------------------
+// Incremental state
+//------------------------------------------------------------
+
+void CrossingState::reset(
+    const vector<pair<double,double>>& positions,
+    const vector<vector<int>>& adj)
+{
+    index.build(positions, adj);
+    total = index.countCrossings(&perEdge);
+}
+
+bool CrossingState::matches(int vertexCount, int edgeCount) const
+{
+    return vertexCount == index.vertexCount() && edgeCount == index.edgeCount();
+}
+
+// Adds sign * (crossings of the edges at v) to the counters, using the
+// current position of v. Edges that both touch v share an endpoint and
+// never cross, so each affected pair is visited exactly once.
+void CrossingState::accumulate(int v, int sign)
+{
+    const auto& pos = index.positions();
+    const auto& edges = index.edgeList();
+    vector<int> hits;
+
+    for (int e : index.incidentEdges(v)) {
+        int a = edges[e].first, b = edges[e].second;
+        hits.clear();
+        index.segmentCrossings(pos[a].first, pos[a].second, pos[b].first, pos[b].second,
+                               a, b, &hits);
+        for (int f : hits) {
+            total += sign;
+            perEdge[e] += sign;
+            perEdge[f] += sign;
+        }
+    }
+}
+
+void CrossingState::moveVertex(int v, double x, double y)
+{
+    if (v < 0 || v >= index.vertexCount()) return;
+    const auto& p = index.positions()[v];
+    if (p.first == x && p.second == y) return;
+
+    accumulate(v, -1);
+    index.moveVertex(v, x, y);
+    accumulate(v, +1);
+}
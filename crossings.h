@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <functional>
+
+// Shared crossing counter used by the solver and by the UI.
+// Two edges cross when they share no endpoint and segmentsIntersect() holds.
+class CrossingCounter {
+public:
+    // Proper intersection test of segments AB and CD (orientation based)
+    static bool segmentsIntersect(
+        double Ax, double Ay, double Bx, double By,
+        double Cx, double Cy, double Dx, double Dy);
+
+    // Edges (u < v) of the first n vertices, in the order used for edge ids
+    static std::vector<std::pair<int, int>> edgeList(
+        const std::vector<std::vector<int>>& adj, int n);
+
+    // Bentley-Ottmann sweep, O((E + K) log E) for K crossings.
+    // perEdge, when given, receives the crossings of every edge id.
+    static int count(
+        const std::vector<std::pair<double, double>>& pos,
+        const std::vector<std::vector<int>>& adj,
+        std::vector<int>* perEdge = nullptr);
+
+    // Reference O(E^2) pair scan, same semantics as count()
+    static int countBruteForce(
+        const std::vector<std::pair<double, double>>& pos,
+        const std::vector<std::vector<int>>& adj,
+        std::vector<int>* perEdge = nullptr);
+};
+
+// Uniform grid over the bounding boxes of the edges of a drawing. Crossing
+// tests only run between edges that share a cell, which is cheap for the
+// short edges of solver layouts. A pair sharing several cells is tested in
+// the first of them only. Moving a vertex re-buckets its edges, so one index
+// serves a whole sequence of edits. Points outside the grid built by build()
+// are clamped into the border cells: still exact, just slower.
+class EdgeIndex {
+public:
+    // cellSize <= 0 derives the cell size from the drawing
+    void build(const std::vector<std::pair<double, double>>& positions,
+               const std::vector<std::vector<int>>& adj,
+               double cellSize = 0);
+
+    // Same from an edge list (u < v), e.g. a CsrGraph's edges
+    void build(const std::vector<std::pair<double, double>>& positions,
+               const std::vector<std::pair<int, int>>& edgePairs,
+               double cellSize = 0);
+
+    void moveVertex(int v, double x, double y);
+
+    int vertexCount() const { return (int)pos.size(); }
+    int edgeCount() const { return (int)edges.size(); }
+    const std::vector<std::pair<double, double>>& positions() const { return pos; }
+    const std::vector<std::pair<int, int>>& edgeList() const { return edges; }
+    const std::vector<int>& incidentEdges(int v) const { return incident[v]; }
+
+    // Same result as CrossingCounter::countBruteForce(). stop, when given,
+    // is polled as the count goes; a stopped count returns -1.
+    int countCrossings(std::vector<int>* perEdge = nullptr,
+                       const std::function<bool()>& stop = nullptr) const;
+
+    // Edges crossing segment AB, ignoring edges at vertex a or b (pass -1
+    // for a free endpoint). Ids are appended to hits when given.
+    int segmentCrossings(double Ax, double Ay, double Bx, double By,
+                         int a, int b, std::vector<int>* hits = nullptr) const;
+
+    // Ids of the edges whose bounding box meets [x0, x1] x [y0, y1], each
+    // once, appended to out
+    void edgesInBox(double x0, double y0, double x1, double y1, std::vector<int>& out) const;
+
+private:
+    struct CellRange { int x0, y0, x1, y1; };
+
+    int cellX(double x) const;
+    int cellY(double y) const;
+    CellRange rangeOf(double Ax, double Ay, double Bx, double By) const;
+    void insertEdge(int e);
+    void removeEdge(int e);
+
+    double originX = 0, originY = 0, cell = 1;
+    int gridW = 1, gridH = 1;
+    std::vector<std::vector<int>> cells;     // row-major, edge ids
+    std::vector<CellRange> ranges;           // edge id -> covered cells
+
+    std::vector<std::pair<double, double>> pos;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<std::vector<int>> incident;  // vertex -> edge ids
+};
+
+// Crossing counts of a drawing that is edited one vertex at a time.
+// reset() does a full count, moveVertex() only re-tests the edges incident
+// to the moved vertex against the edges sharing their grid cells.
+class CrossingState {
+public:
+    void reset(const std::vector<std::pair<double, double>>& positions,
+               const std::vector<std::vector<int>>& adj);
+
+    // Cheap staleness check against the drawing the caller holds
+    bool matches(int vertexCount, int edgeCount) const;
+
+    void moveVertex(int v, double x, double y);
+
+    int totalCrossings() const { return total; }
+    const std::vector<int>& edgeCrossings() const { return perEdge; }
+
+private:
+    void accumulate(int v, int sign);
+
+    int total = 0;
+    EdgeIndex index;
+    std::vector<int> perEdge;
+};
@@ -0,0 +1,26 @@
+#include "csrgraph.h"
+
+using namespace std;
+
+CsrGraph::CsrGraph(const vector<vector<int>>& adj, int vertices)
+{
+    n = vertices < (int)adj.size() ? vertices : (int)adj.size();
+    if (n < 0) n = 0;
+
+    offset.assign(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        int d = 0;
+        for (int v : adj[u])
+            if (v >= 0 && v < n) d++;
+        offset[u + 1] = offset[u] + d;
+    }
+
+    nbr.reserve(offset[n]);
+    edges.reserve(offset[n] / 2);
+    for (int u = 0; u < n; u++)
+        for (int v : adj[u]) {
+            if (v < 0 || v >= n) continue;
+            nbr.push_back(v);
+            if (u < v) edges.push_back({u, v});
+        }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// Compressed sparse row form of an adjacency list, built once per layout so
+// the solver's hot loops walk flat arrays. The neighbours of v are
+// nbr[offset[v]] .. nbr[offset[v + 1] - 1]; edges holds every edge once with
+// u < v, numbered like CrossingCounter::edgeList().
+class CsrGraph {
+public:
+    struct Range {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return (int)(last - first); }
+    };
+
+    CsrGraph() = default;
+
+    // Keeps vertices 0..n-1 and drops entries pointing outside that range
+    CsrGraph(const std::vector<std::vector<int>>& adj, int n);
+
+    int vertexCount() const { return n; }
+    int edgeCount() const { return (int)edges.size(); }
+    int degree(int v) const { return offset[v + 1] - offset[v]; }
+    Range neighbours(int v) const
+    {
+        return Range{nbr.data() + offset[v], nbr.data() + offset[v + 1]};
+    }
+
+    std::vector<int> offset;                  // n + 1 entries
+    std::vector<int> nbr;
+    std::vector<std::pair<int, int>> edges;   // u < v
+
+private:
+    int n = 0;
+};
@@ -0,0 +1,227 @@
+#include "heuristics.h"
+#include "kdtree.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Force-directed layout (Fruchterman-Reingold) with Barnes-Hut
+// repulsion, snapped onto the candidate grid
+//------------------------------------------------------------
+
+namespace {
+
+// A cell is treated as one body when size / distance < BarnesHutTheta
+const double BarnesHutTheta = 0.8;
+const int MaxTreeDepth = 32;
+
+// Iterations shrink with V so one run stays near IterationBudget
+// V log V steps of tree walking
+const int MinIterations = 30;
+const int MaxIterations = 300;
+const double IterationBudget = 1e7;
+
+// Quadtree over the current positions; every cell keeps the mass and the
+// centre of mass of the vertices below it
+class QuadTree {
+public:
+    void build(const vector<double>& x, const vector<double>& y)
+    {
+        cells.clear();
+        double x0 = *min_element(x.begin(), x.end()), x1 = *max_element(x.begin(), x.end());
+        double y0 = *min_element(y.begin(), y.end()), y1 = *max_element(y.begin(), y.end());
+        cells.push_back(Cell{x0, y0, max({x1 - x0, y1 - y0, 1e-9})});
+        for (int v = 0; v < (int)x.size(); v++)
+            insert(v, x[v], y[v]);
+    }
+
+    // Repulsion on (px, py) from everything but vertex self, scaled by k2
+    void repulsion(int self, double px, double py, double k2, double& fx, double& fy) const
+    {
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const Cell& c = cells[stack.back()];
+            stack.pop_back();
+            if (c.mass == 0 || (c.body == self && c.mass == 1)) continue;
+
+            double mass = c.mass, mx = c.mx / c.mass, my = c.my / c.mass;
+            if (c.body == self) {   // a merged leaf that holds self: leave it out
+                mass -= 1;
+                mx = (c.mx - px) / mass;
+                my = (c.my - py) / mass;
+            }
+
+            double dx = px - mx, dy = py - my;
+            double d2 = dx * dx + dy * dy;
+            bool leaf = c.child[0] < 0;
+            if (leaf || c.size * c.size < BarnesHutTheta * BarnesHutTheta * d2) {
+                d2 = max(d2, 1e-4);
+                fx += dx * k2 * mass / d2;
+                fy += dy * k2 * mass / d2;
+            } else {
+                for (int q : c.child)
+                    if (q >= 0) stack.push_back(q);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        double x0, y0, size;
+        double mass = 0, mx = 0, my = 0;     // mx, my: mass-weighted sums
+        int body = -1;                       // vertex of a leaf
+        int child[4] = {-1, -1, -1, -1};
+        int depth = 0;
+    };
+
+    int quadrant(const Cell& c, double px, double py) const
+    {
+        double h = c.size / 2;
+        return (px >= c.x0 + h ? 1 : 0) + (py >= c.y0 + h ? 2 : 0);
+    }
+
+    int childCell(int parent, int q)
+    {
+        if (cells[parent].child[q] < 0) {
+            const Cell& c = cells[parent];
+            double h = c.size / 2;
+            Cell n{c.x0 + (q & 1 ? h : 0), c.y0 + (q & 2 ? h : 0), h};
+            n.depth = c.depth + 1;
+            cells[parent].child[q] = (int)cells.size();
+            cells.push_back(n);
+        }
+        return cells[parent].child[q];
+    }
+
+    void insert(int v, double px, double py)
+    {
+        int at = 0;
+        while (true) {
+            Cell& c = cells[at];
+            bool emptyLeaf = c.mass == 0 && c.child[0] < 0 && c.child[1] < 0
+                             && c.child[2] < 0 && c.child[3] < 0;
+            c.mass += 1;
+            c.mx += px;
+            c.my += py;
+            if (emptyLeaf) {
+                c.body = v;
+                return;
+            }
+            if (c.depth >= MaxTreeDepth) return;   // coincident points stay merged
+
+            if (c.body >= 0) {
+                // Push the resident body one level down first
+                int old = c.body;
+                double ox = (c.mx - px) / (c.mass - 1), oy = (c.my - py) / (c.mass - 1);
+                cells[at].body = -1;
+                int q = quadrant(cells[at], ox, oy);
+                int down = childCell(at, q);
+                Cell& d = cells[down];
+                d.mass = 1;
+                d.mx = ox;
+                d.my = oy;
+                d.body = old;
+            }
+            at = childCell(at, quadrant(cells[at], px, py));
+        }
+    }
+
+    vector<Cell> cells;
+    mutable vector<int> stack;
+};
+
+} // namespace
+
+vector<int> force_directed_assignment(
+    int V,
+    const CsrGraph& g,
+    const vector<pair<double,double>>& coords,
+    int r,
+    unsigned seed,
+    const SolverControl& control)
+{
+    if (V <= 0) return {};
+
+    // Cancelled before starting: any valid layout will do
+    vector<int> trivial(V);
+    iota(trivial.begin(), trivial.end(), 0);
+    if (control.cancelled()) return trivial;
+
+    // Start from the 2D barycentric placement: already untangled locally,
+    // so far fewer iterations are needed than from random points
+    vector<int> start = barycentric_2d_assignment(V, g, coords, spiralOrder(r), control);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> jitter(-0.1, 0.1);
+    vector<double> x(V), y(V);
+    for (int v = 0; v < V; v++) {
+        x[v] = coords[start[v]].first + jitter(rng);
+        y[v] = coords[start[v]].second + jitter(rng);
+    }
+
+    const double k = r / sqrt((double)V);       // ideal edge length
+    const double k2 = k * k;
+    const double gravity = 0.01;                // keeps components together
+    const double centre = r / 2.0;
+
+    double nlogn = V * log2(V + 1.0);
+    int iterations = clamp((int)(IterationBudget / max(1.0, nlogn)), MinIterations, MaxIterations);
+
+    QuadTree tree;
+    vector<double> fx(V), fy(V);
+    double temperature = r / 10.0;
+    const double cooling = temperature / iterations;
+
+    for (int it = 0; it < iterations; it++) {
+        if (control.cancelled()) break;
+
+        tree.build(x, y);
+        for (int v = 0; v < V; v++) {
+            fx[v] = gravity * (centre - x[v]);
+            fy[v] = gravity * (centre - y[v]);
+            tree.repulsion(v, x[v], y[v], k2, fx[v], fy[v]);
+        }
+
+        for (const auto& e : g.edges) {
+            double dx = x[e.first] - x[e.second], dy = y[e.first] - y[e.second];
+            double d = sqrt(dx * dx + dy * dy);
+            double pull = d / k;                // |F| = d^2 / k
+            fx[e.first] -= dx * pull;
+            fy[e.first] -= dy * pull;
+            fx[e.second] += dx * pull;
+            fy[e.second] += dy * pull;
+        }
+
+        for (int v = 0; v < V; v++) {
+            double len = sqrt(fx[v] * fx[v] + fy[v] * fy[v]);
+            if (len > 0) {
+                double step = min(len, temperature) / len;
+                x[v] += fx[v] * step;
+                y[v] += fy[v] * step;
+            }
+        }
+        temperature = max(temperature - cooling, 1e-3);
+    }
+    if (control.cancelled()) return trivial;
+
+    // Stretch the drawing over the grid, then snap: high degree vertices
+    // pick their nearest free cell first
+    double x0 = *min_element(x.begin(), x.end()), x1 = *max_element(x.begin(), x.end());
+    double y0 = *min_element(y.begin(), y.end()), y1 = *max_element(y.begin(), y.end());
+    double sx = x1 > x0 ? (r - 1) / (x1 - x0) : 0, sy = y1 > y0 ? (r - 1) / (y1 - y0) : 0;
+
+    vector<int> order(V);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return g.degree(a) > g.degree(b); });
+
+    KdTree free_cells(coords);
+    vector<int> assignment(V, -1);
+    for (int v : order) {
+        assignment[v] = free_cells.nearest((x[v] - x0) * sx, (y[v] - y0) * sy);
+        free_cells.remove(assignment[v]);
+    }
+    return assignment;
+}
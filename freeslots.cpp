@@ -0,0 +1,61 @@
+#include "freeslots.h"
+
+using namespace std;
+
+FreeSlots::FreeSlots(int size)
+    : n(size < 0 ? 0 : size), freeTotal(n), tree(n + 1, 0), free_(n, 1)
+{
+    // Linear build: every slot counts 1, pushed up to its parent
+    for (int i = 1; i <= n; i++) {
+        tree[i] += 1;
+        int parent = i + (i & -i);
+        if (parent <= n) tree[parent] += tree[i];
+    }
+    topBit = 1;
+    while (topBit * 2 <= n) topBit *= 2;
+}
+
+void FreeSlots::take(int s)
+{
+    if (!isFree(s)) return;
+    free_[s] = 0;
+    freeTotal--;
+    for (int i = s + 1; i <= n; i += i & -i)
+        tree[i]--;
+}
+
+int FreeSlots::countUpTo(int s) const
+{
+    int count = 0;
+    for (int i = s + 1; i > 0; i -= i & -i)
+        count += tree[i];
+    return count;
+}
+
+int FreeSlots::kth(int k) const
+{
+    int pos = 0;
+    for (int step = topBit; step > 0; step >>= 1) {
+        if (pos + step <= n && tree[pos + step] < k) {
+            pos += step;
+            k -= tree[pos];
+        }
+    }
+    return pos;   // 0-based slot
+}
+
+int FreeSlots::predecessor(int s) const
+{
+    if (n == 0 || s < 0) return -1;
+    if (s >= n) s = n - 1;
+    int c = countUpTo(s);
+    return c == 0 ? -1 : kth(c);
+}
+
+int FreeSlots::successor(int s) const
+{
+    if (n == 0 || s >= n) return -1;
+    if (s < 0) s = 0;
+    int c = s > 0 ? countUpTo(s - 1) : 0;
+    return c == freeTotal ? -1 : kth(c + 1);
+}
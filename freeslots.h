@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+// Ordered set of free slots 0..n-1 on a Fenwick tree. Slots are only ever
+// taken, never returned; nearest-free queries run in O(log n).
+class FreeSlots {
+public:
+    explicit FreeSlots(int n = 0);
+
+    int size() const { return n; }
+    int freeCount() const { return freeTotal; }
+    bool isFree(int s) const { return s >= 0 && s < n && free_[s]; }
+
+    void take(int s);
+
+    // Largest free slot <= s / smallest free slot >= s, -1 if none
+    int predecessor(int s) const;
+    int successor(int s) const;
+
+private:
+    int countUpTo(int s) const;   // free slots in [0, s]
+    int kth(int k) const;         // k-th free slot, 1-based
+
+    int n = 0;
+    int topBit = 0;
+    int freeTotal = 0;
+    std::vector<int> tree;        // 1-based Fenwick counts
+    std::vector<char> free_;
+};
@@ -0,0 +1,334 @@
+#include "graphglrenderer.h"
+#include "graphwidget.h"
+#include <QOpenGLContext>
+#include <QVector2D>
+#include <QVector4D>
+#include <QDebug>
+#include <cstddef>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Shaders. Positions are in graph coordinates; viewScale and
+// viewOffset map them to clip space, so a pan or zoom touches
+// only uniforms. pixel is one screen pixel in graph units and
+// sets the width of the antialiased fringe.
+//------------------------------------------------------------
+
+namespace {
+
+const char* NodeVertex = R"(
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec2 center;
+layout(location = 2) in vec4 fill;
+layout(location = 3) in vec4 border;
+uniform vec2 viewScale;
+uniform vec2 viewOffset;
+uniform float radius;
+uniform float pixel;
+out vec2 local;
+out vec4 vFill;
+out vec4 vBorder;
+void main()
+{
+    local = corner * (radius + 1.5 * pixel);
+    vFill = fill;
+    vBorder = border;
+    gl_Position = vec4((center + local) * viewScale + viewOffset, 0.0, 1.0);
+}
+)";
+
+const char* NodeFragment = R"(
+in vec2 local;
+in vec4 vFill;
+in vec4 vBorder;
+uniform float radius;
+uniform float borderWidth;
+uniform float pixel;
+out vec4 fragColor;
+void main()
+{
+    float d = length(local);
+    float outer = radius + 0.5 * borderWidth;
+    float inner = radius - 0.5 * borderWidth;
+    float coverage = 1.0 - smoothstep(outer - 0.5 * pixel, outer + 0.5 * pixel, d);
+    if (coverage <= 0.0) discard;
+    vec4 c = mix(vFill, vBorder, smoothstep(inner - 0.5 * pixel, inner + 0.5 * pixel, d));
+    fragColor = vec4(c.rgb, c.a * coverage);
+}
+)";
+
+const char* EdgeVertex = R"(
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 ends;
+uniform vec2 viewScale;
+uniform vec2 viewOffset;
+uniform float halfWidth;
+uniform float pixel;
+out float across;
+void main()
+{
+    vec2 a = ends.xy;
+    vec2 b = ends.zw;
+    vec2 d = b - a;
+    float len = length(d);
+    vec2 dir = len > 0.0 ? d / len : vec2(1.0, 0.0);
+    float w = max(halfWidth, 0.5 * pixel) + pixel;
+    across = corner.y * w;
+    vec2 p = mix(a, b, corner.x) + vec2(-dir.y, dir.x) * across;
+    gl_Position = vec4(p * viewScale + viewOffset, 0.0, 1.0);
+}
+)";
+
+const char* EdgeFragment = R"(
+in float across;
+uniform float halfWidth;
+uniform float pixel;
+uniform vec4 color;
+out vec4 fragColor;
+void main()
+{
+    float w = max(halfWidth, 0.5 * pixel);
+    float coverage = 1.0 - smoothstep(w - 0.5 * pixel, w + 0.5 * pixel, abs(across));
+    if (coverage <= 0.0) discard;
+    fragColor = vec4(color.rgb, color.a * coverage);
+}
+)";
+
+// Triangle strips: a disc's square, then a segment's rectangle
+// (x along the segment, y across it)
+const GLfloat QuadCorners[] = {
+    -1, -1,   1, -1,   -1, 1,   1, 1,
+     0, -1,   1, -1,    0, 1,   1, 1,
+};
+
+// Matches the raster path: radius 5 with a 1 unit border, 2 unit edges
+const float NodeRadius = 5.0f;
+const float NodeBorder = 1.0f;
+const float EdgeHalfWidth = 1.0f;
+
+bool build(QOpenGLShaderProgram& program, const char* vertex, const char* fragment)
+{
+    const QByteArray header = QOpenGLContext::currentContext()->isOpenGLES()
+        ? QByteArrayLiteral("#version 300 es\nprecision highp float;\n")
+        : QByteArrayLiteral("#version 330 core\n");
+    return program.addShaderFromSourceCode(QOpenGLShader::Vertex, header + vertex)
+        && program.addShaderFromSourceCode(QOpenGLShader::Fragment, header + fragment)
+        && program.link();
+}
+
+} // namespace
+
+QSurfaceFormat GraphGLRenderer::requiredFormat()
+{
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+#if QT_CONFIG(opengles2)
+    format.setVersion(3, 0);
+#else
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+#endif
+    return format;
+}
+
+void GraphGLRenderer::initialize()
+{
+    // A program keeps its id once linked, so each context gets new ones
+    release();
+    initializeOpenGLFunctions();
+
+    nodeProgram = make_unique<QOpenGLShaderProgram>();
+    edgeProgram = make_unique<QOpenGLShaderProgram>();
+    ready = build(*nodeProgram, NodeVertex, NodeFragment) &&
+            build(*edgeProgram, EdgeVertex, EdgeFragment);
+    if (!ready) {
+        qWarning() << "GraphGLRenderer: shaders failed:" << nodeProgram->log() << edgeProgram->log();
+        return;
+    }
+
+    quad = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    quad.create();
+    quad.bind();
+    quad.allocate(QuadCorners, sizeof(QuadCorners));
+
+    nodeBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    nodeBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    nodeBuffer.create();
+    edgeBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    edgeBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    edgeBuffer.create();
+
+    // Nodes: corner per vertex, the rest per instance
+    nodeVao.create();
+    nodeVao.bind();
+    quad.bind();
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    nodeBuffer.bind();
+    const GLsizei nodeStride = sizeof(NodeInstance);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, nodeStride,
+                          reinterpret_cast<void*>(offsetof(NodeInstance, x)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, nodeStride,
+                          reinterpret_cast<void*>(offsetof(NodeInstance, fill)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, nodeStride,
+                          reinterpret_cast<void*>(offsetof(NodeInstance, border)));
+    for (GLuint a = 1; a <= 3; a++) glVertexAttribDivisor(a, 1);
+    nodeVao.release();
+
+    // Edges: the second half of the quad buffer
+    edgeVao.create();
+    edgeVao.bind();
+    quad.bind();
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(8 * sizeof(GLfloat)));
+    edgeBuffer.bind();
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(EdgeInstance), nullptr);
+    glVertexAttribDivisor(1, 1);
+    edgeVao.release();
+}
+
+void GraphGLRenderer::release()
+{
+    nodeVao.destroy();
+    edgeVao.destroy();
+    quad.destroy();
+    nodeBuffer.destroy();
+    edgeBuffer.destroy();
+    nodeProgram.reset();
+    edgeProgram.reset();
+    ready = false;
+}
+
+GraphGLRenderer::NodeInstance GraphGLRenderer::instanceOf(const NodeInfo& node)
+{
+    NodeInstance in;
+    in.x = (GLfloat)node.x;
+    in.y = (GLfloat)node.y;
+    const QColor& f = node.color;
+    const QColor& b = node.colorBorder;
+    in.fill[0] = f.red();  in.fill[1] = f.green();  in.fill[2] = f.blue();  in.fill[3] = f.alpha();
+    in.border[0] = b.red(); in.border[1] = b.green(); in.border[2] = b.blue(); in.border[3] = b.alpha();
+    return in;
+}
+
+GraphGLRenderer::EdgeInstance GraphGLRenderer::edgeInstance(int e) const
+{
+    const NodeInstance& a = nodeData[edges[e].first];
+    const NodeInstance& b = nodeData[edges[e].second];
+    return {a.x, a.y, b.x, b.y};
+}
+
+void GraphGLRenderer::upload(const vector<NodeInfo>& nodes, const vector<pair<int,int>>& edgeList)
+{
+    const int n = (int)nodes.size();
+    nodeData.resize(n);
+    for (int v = 0; v < n; v++) nodeData[v] = instanceOf(nodes[v]);
+
+    edges.clear();
+    for (const auto& e : edgeList)
+        if (e.first >= 0 && e.second >= 0 && e.first < n && e.second < n && e.first != e.second)
+            edges.push_back(e);
+
+    incidentStart.assign(n + 1, 0);
+    for (const auto& e : edges) { incidentStart[e.first + 1]++; incidentStart[e.second + 1]++; }
+    for (int v = 0; v < n; v++) incidentStart[v + 1] += incidentStart[v];
+    incidentEdges.resize(incidentStart[n]);
+    vector<int> fill(incidentStart.begin(), incidentStart.end() - 1);
+    for (int e = 0; e < (int)edges.size(); e++) {
+        incidentEdges[fill[edges[e].first]++] = e;
+        incidentEdges[fill[edges[e].second]++] = e;
+    }
+
+    edgeData.resize(edges.size());
+    for (int e = 0; e < (int)edges.size(); e++) edgeData[e] = edgeInstance(e);
+
+    if (!ready) return;
+    nodeBuffer.bind();
+    nodeBuffer.allocate(nodeData.data(), (int)(nodeData.size() * sizeof(NodeInstance)));
+    edgeBuffer.bind();
+    edgeBuffer.allocate(edgeData.data(), (int)(edgeData.size() * sizeof(EdgeInstance)));
+}
+
+void GraphGLRenderer::update(const vector<NodeInfo>& nodes, const vector<int>* changed)
+{
+    const int n = nodeCount();
+    if ((int)nodes.size() != n) return;
+
+    // A drag writes a node and its edges; an animation frame rewrites both
+    // buffers in one go each, still without reallocating them
+    if (changed) {
+        for (int v : *changed)
+            if (v >= 0 && v < n) nodeData[v] = instanceOf(nodes[v]);
+        if (!ready) return;
+        nodeBuffer.bind();
+        for (int v : *changed)
+            if (v >= 0 && v < n)
+                nodeBuffer.write(v * (int)sizeof(NodeInstance), &nodeData[v], sizeof(NodeInstance));
+        edgeBuffer.bind();
+        for (int v : *changed) {
+            if (v < 0 || v >= n) continue;
+            for (int i = incidentStart[v]; i < incidentStart[v + 1]; i++) {
+                int e = incidentEdges[i];
+                edgeData[e] = edgeInstance(e);
+                edgeBuffer.write(e * (int)sizeof(EdgeInstance), &edgeData[e], sizeof(EdgeInstance));
+            }
+        }
+        return;
+    }
+
+    for (int v = 0; v < n; v++) nodeData[v] = instanceOf(nodes[v]);
+    for (int e = 0; e < (int)edges.size(); e++) edgeData[e] = edgeInstance(e);
+    if (!ready) return;
+    nodeBuffer.bind();
+    nodeBuffer.write(0, nodeData.data(), (int)(nodeData.size() * sizeof(NodeInstance)));
+    edgeBuffer.bind();
+    edgeBuffer.write(0, edgeData.data(), (int)(edgeData.size() * sizeof(EdgeInstance)));
+}
+
+void GraphGLRenderer::render(int width, int height, double devicePixelRatio,
+                             double zoom, double offsetX, double offsetY)
+{
+    glViewport(0, 0, (GLsizei)(width * devicePixelRatio), (GLsizei)(height * devicePixelRatio));
+    glClearColor(1, 1, 1, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!ready || width <= 0 || height <= 0) return;
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Screen x = graph x * zoom + offsetX, then to [-1, 1] with y down
+    const QVector2D viewScale(2 * zoom / width, -2 * zoom / height);
+    const QVector2D viewOffset(2 * offsetX / width - 1, 1 - 2 * offsetY / height);
+    const float pixel = (float)(1.0 / (zoom * devicePixelRatio));
+
+    if (!edgeData.empty()) {
+        const QColor c(Qt::darkGray);
+        edgeProgram->bind();
+        edgeProgram->setUniformValue("viewScale", viewScale);
+        edgeProgram->setUniformValue("viewOffset", viewOffset);
+        edgeProgram->setUniformValue("halfWidth", EdgeHalfWidth);
+        edgeProgram->setUniformValue("pixel", pixel);
+        edgeProgram->setUniformValue("color", QVector4D(c.redF(), c.greenF(), c.blueF(), c.alphaF()));
+        edgeVao.bind();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)edgeData.size());
+        edgeVao.release();
+    }
+
+    if (!nodeData.empty()) {
+        nodeProgram->bind();
+        nodeProgram->setUniformValue("viewScale", viewScale);
+        nodeProgram->setUniformValue("viewOffset", viewOffset);
+        nodeProgram->setUniformValue("radius", NodeRadius);
+        nodeProgram->setUniformValue("borderWidth", NodeBorder);
+        nodeProgram->setUniformValue("pixel", pixel);
+        nodeVao.bind();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)nodeData.size());
+        nodeVao.release();
+    }
+    nodeProgram->release();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QSurfaceFormat>
+#include <vector>
+#include <utility>
+#include <memory>
+
+struct NodeInfo;
+
+// OpenGL drawing of GraphWidget's edges and nodes (CLARITY_OPENGL builds).
+// Nodes are instanced quads shaded into bordered discs, edges instanced
+// quads along each segment, both antialiased in the fragment shader. The
+// instance buffers are written in place when nodes move; zoom and pan are
+// uniforms only. Needs OpenGL 3.3 core or OpenGL ES 3.0, which Mesa's
+// llvmpipe provides, so no GPU is required.
+// All members but requiredFormat must be called with the widget's context
+// current.
+class GraphGLRenderer : protected QOpenGLExtraFunctions {
+public:
+    // The default format with the version the shaders need; set it as the
+    // default before the application object is created
+    static QSurfaceFormat requiredFormat();
+
+    // initialize may run again on a new context (the widget was reparented
+    // or moved to another screen); it drops whatever the last one left
+    void initialize();
+    void release();
+
+    int nodeCount() const { return (int)nodeData.size(); }
+
+    // Full upload: the node set or the edges changed
+    void upload(const std::vector<NodeInfo>& nodes, const std::vector<std::pair<int, int>>& edges);
+
+    // Rewrites the instances of the changed nodes and of their edges, or
+    // of all of them when changed is null. Node count must match the last
+    // upload
+    void update(const std::vector<NodeInfo>& nodes, const std::vector<int>* changed);
+
+    // width and height in logical pixels; clears to white first
+    void render(int width, int height, double devicePixelRatio,
+                double zoom, double offsetX, double offsetY);
+
+private:
+    struct NodeInstance {
+        GLfloat x, y;
+        GLubyte fill[4];
+        GLubyte border[4];
+    };
+    struct EdgeInstance {
+        GLfloat x0, y0, x1, y1;
+    };
+
+    static NodeInstance instanceOf(const NodeInfo& node);
+    EdgeInstance edgeInstance(int e) const;
+
+    bool ready = false;
+    std::unique_ptr<QOpenGLShaderProgram> nodeProgram, edgeProgram;   // per context
+    QOpenGLVertexArrayObject nodeVao, edgeVao;
+    QOpenGLBuffer quad, nodeBuffer, edgeBuffer;
+
+    std::vector<NodeInstance> nodeData;
+    std::vector<EdgeInstance> edgeData;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<int> incidentStart, incidentEdges;   // CSR: node -> edges
+};
@@ -3,9 +3,19 @@
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <QtMath>
+#include <QFontMetricsF>
+#include <algorithm>
+#ifdef CLARITY_OPENGL
+#include <QOpenGLContext>
+#endif
+
+// How far past the viewport a node can still show: its halo, and its
+// label, which starts right of and above it
+static const double HaloReach = 16;
+static const double LabelReachX = 200, LabelReachY = 24;
 
 GraphWidget::GraphWidget(QWidget *parent)
-    : QWidget(parent)
+    : GraphWidgetBase(parent)
 {
     setMouseTracking(true);
 
@@ -14,6 +24,9 @@ GraphWidget::GraphWidget(QWidget *parent)
     pal.setColor(QPalette::Window, Qt::white);
     setPalette(pal);
 
+    labelFont = QFont("Arial", 10);
+    labelAscent = QFontMetricsF(labelFont).ascent();
+
     // Animation timer ~60 FPS
     connect(&animTimer, &QTimer::timeout, this, [this]() {
         if (!animating) { animTimer.stop(); return; }
@@ -35,12 +48,13 @@ GraphWidget::GraphWidget(QWidget *parent)
             nodes[i].x = nx;
             nodes[i].y = ny;
         }
-        update();
-        emit nodeMoved(); // allow live crossing updates
+        nodesChanged();
+        emit nodeMoved(-1); // allow live crossing updates
 
         if (t >= 1.0 - 1e-6) {
             animating = false;
             animTimer.stop();
+            if (clustersStale && !draggingNode) clustersDirty = true;
         }
     });
 
@@ -50,14 +64,35 @@ GraphWidget::GraphWidget(QWidget *parent)
 
 void GraphWidget::setNodes(const std::vector<NodeInfo> &nd) {
     nodes = nd;
+    sceneDirty = true;
+#ifdef CLARITY_OPENGL
+    glSceneDirty = true;
+#endif
+    resetSelection();
     update();
 }
 
 void GraphWidget::setAdjacency(const std::vector<std::vector<int>> &g) {
     adj = g;
+    sceneDirty = true;
+#ifdef CLARITY_OPENGL
+    glSceneDirty = true;
+#endif
+    resetSelection();
     update();
 }
 
+// After a node set change the selected ids may name other nodes or none
+void GraphWidget::resetSelection()
+{
+    if (selectedNode >= static_cast<int>(nodes.size())) selectedNode = -1;
+    const bool had = !selection.empty();
+    selection.clear();
+    selectionMask.assign(nodes.size(), false);
+    layerDirty = true;
+    if (had) emit selectionChanged();
+}
+
 void GraphWidget::animateTo(const std::vector<QPointF> &targets, int durationMs)
 {
     if (targets.size() != nodes.size()) {
@@ -82,6 +117,132 @@ void GraphWidget::animateTo(const std::vector<QPointF> &targets, int durationMs)
     if (!animTimer.isActive()) animTimer.start(16);
 }
 
+void GraphWidget::syncSceneIndex()
+{
+    const int n = static_cast<int>(nodes.size());
+
+    // While a drag or an animation moves nodes the cluster tree only goes
+    // stale; it is rebuilt once they stop. A new node set rebuilds it anyway
+    const bool moving = draggingNode || animating;
+    auto invalidateClusters = [&]() {
+        if (moving && !sceneDirty && clusterTree.nodeCount() == n) clustersStale = true;
+        else clustersDirty = true;
+    };
+
+    if (!sceneDirty && !sceneChanged.all && sceneIndex.nodeCount() == n) {
+        // Few moved (a drag): move them in the index. Many moved (an
+        // animation frame): a rebuild is cheaper than moving them one by one
+        const auto &known = sceneIndex.positions();
+        bool moved = false;
+        for (int v : sceneChanged.ids) {
+            if (v >= n || (known[v].first == nodes[v].x && known[v].second == nodes[v].y))
+                continue;
+            sceneIndex.moveNode(v, nodes[v].x, nodes[v].y);
+            moved = true;
+            if (v != draggedNodeIndex) layerDirty = true;
+        }
+        if (moved) invalidateClusters();
+        sceneChanged.clear();
+        return;
+    }
+
+    std::vector<std::pair<double,double>> pos;
+    pos.reserve(n);
+    for (const auto &nd : nodes) pos.emplace_back(nd.x, nd.y);
+    sceneIndex.build(pos, adj);
+    invalidateClusters();
+    sceneDirty = false;
+    sceneChanged.clear();
+    layerDirty = true;
+}
+
+void GraphWidget::ChangedNodes::add(int index, int nodeCount)
+{
+    if (all) return;
+    if (index < 0 || index >= nodeCount || (int)ids.size() >= nodeCount / 4) {
+        ids.clear();
+        all = true;
+        return;
+    }
+    ids.push_back(index);
+}
+
+void GraphWidget::nodesChanged(int index)
+{
+    const int n = static_cast<int>(nodes.size());
+    sceneChanged.add(index, n);
+#ifdef CLARITY_OPENGL
+    glChanged.add(index, n);
+#endif
+    update();
+}
+
+void GraphWidget::paintClusters(QPainter &p, const QPointF &topLeft, const QPointF &bottomRight)
+{
+    if (clustersDirty) {
+        clusterTree.build(sceneIndex.positions(), sceneIndex.edgeList());
+        clustersDirty = false;
+        clustersStale = false;
+    }
+
+    const int level = clusterTree.levelFor(ClusterCellPx / zoom);
+    const auto &clusters = clusterTree.clusters(level);
+    const double x0 = topLeft.x(), y0 = topLeft.y();
+    const double x1 = bottomRight.x(), y1 = bottomRight.y();
+
+    // ------------------------
+    // Links between clusters: one batch per weight class, heavier
+    // bundles drawn darker and wider on top
+    // ------------------------
+    std::vector<QLineF> batches[3];
+    for (const auto &link : clusterTree.links(level)) {
+        const auto &a = clusters[link.a];
+        const auto &b = clusters[link.b];
+        if (std::max(a.x, b.x) < x0 || std::min(a.x, b.x) > x1 ||
+            std::max(a.y, b.y) < y0 || std::min(a.y, b.y) > y1)
+            continue;
+        int k = link.weight >= 16 ? 2 : link.weight >= 4 ? 1 : 0;
+        batches[k].push_back(QLineF(a.x, a.y, b.x, b.y));
+    }
+    for (int k = 0; k < 3; ++k) {
+        QPen pen(QColor(100, 100, 100, 80 + 60 * k), 1 + k);
+        pen.setCosmetic(true);
+        p.setPen(pen);
+        p.drawLines(batches[k].data(), static_cast<int>(batches[k].size()));
+    }
+
+    // ------------------------
+    // Cluster glyphs: area grows with the node count, coloured like the
+    // node that stands for the cluster
+    // ------------------------
+    const double reach = ClusterCellPx / zoom;
+    p.setPen(Qt::NoPen);
+    for (const auto &c : clusters) {
+        if (c.x < x0 - reach || c.x > x1 + reach || c.y < y0 - reach || c.y > y1 + reach)
+            continue;
+        double radiusPx = std::min(1.5 + std::sqrt(static_cast<double>(c.count)), 0.75 * ClusterCellPx);
+        p.setBrush(nodes[c.first].color);
+        p.drawEllipse(QPointF(c.x, c.y), radiusPx / zoom, radiusPx / zoom);
+    }
+
+    // The selection stays visible at any zoom
+    QPen glow(QColor(0, 120, 255, 180), 4);
+    glow.setCosmetic(true);
+    p.setPen(glow);
+    p.setBrush(Qt::NoBrush);
+    auto halo = [&](int i) {
+        const auto &pt = nodes[i];
+        if (pt.x < x0 - reach || pt.x > x1 + reach || pt.y < y0 - reach || pt.y > y1 + reach)
+            return;
+        p.drawEllipse(QPointF(pt.x, pt.y), 8 / zoom, 8 / zoom);
+    };
+    for (int i : selection) halo(i);
+    if (selectedNode >= 0 && selectedNode < static_cast<int>(nodes.size()) &&
+        !std::binary_search(selection.begin(), selection.end(), selectedNode))
+        halo(selectedNode);
+}
+
+#ifndef CLARITY_OPENGL
 void GraphWidget::paintEvent(QPaintEvent *event)
 {
     QPainter p(this);
@@ -89,63 +250,286 @@ void GraphWidget::paintEvent(QPaintEvent *event)
 
     p.fillRect(rect(), Qt::white);
 
+    syncSceneIndex();
+
+    const bool aggregate = zoom < AggregateMaxZoom && static_cast<int>(nodes.size()) >= AggregateMinNodes;
+
+    // While one node is dragged everything else is still: it comes from
+    // the cached layer, and only the node and its edges are drawn over it
+    const bool layered = draggingNode && !animating && !aggregate &&
+                         draggedNodeIndex >= 0 && draggedNodeIndex < static_cast<int>(nodes.size());
+    if (layered) {
+        const double dpr = devicePixelRatioF();
+        if (layerDirty || layerNode != draggedNodeIndex || layerZoom != zoom ||
+            layerOffsetX != offsetX || layerOffsetY != offsetY || staticLayer.size() != size() * dpr) {
+            staticLayer = QPixmap(size() * dpr);
+            staticLayer.setDevicePixelRatio(dpr);
+            staticLayer.fill(Qt::white);
+            QPainter lp(&staticLayer);
+            lp.setRenderHint(QPainter::Antialiasing);
+            lp.translate(offsetX, offsetY);
+            lp.scale(zoom, zoom);
+            paintScene(lp, draggedNodeIndex);
+
+            layerDirty = false;
+            layerNode = draggedNodeIndex;
+            layerZoom = zoom;
+            layerOffsetX = offsetX;
+            layerOffsetY = offsetY;
+        }
+        p.drawPixmap(0, 0, staticLayer);
+
+        p.translate(offsetX, offsetY);
+        p.scale(zoom, zoom);
+
+        const int v = draggedNodeIndex;
+        edgeLines.clear();
+        if (v < static_cast<int>(adj.size()))
+            for (int u : adj[v])
+                if (u >= 0 && u < static_cast<int>(nodes.size()) && u != v)
+                    edgeLines.push_back(QLineF(nodes[v].x, nodes[v].y, nodes[u].x, nodes[u].y));
+        p.setPen(QPen(Qt::darkGray, 2));
+        p.drawLines(edgeLines.data(), static_cast<int>(edgeLines.size()));
+
+        paintNode(p, v);
+        if (zoom >= LabelMinZoom) {
+            p.setPen(Qt::black);
+            paintLabel(p, v);
+        }
+        return;
+    }
+
+    p.translate(offsetX, offsetY);
+    p.scale(zoom, zoom);
+
+    if (aggregate) {
+        QPointF topLeft = screenToGraph(QPointF(0, 0), zoom, offsetX, offsetY);
+        QPointF bottomRight = screenToGraph(QPointF(width(), height()), zoom, offsetX, offsetY);
+        paintClusters(p, topLeft, bottomRight);
+    } else {
+        paintScene(p, -1);
+    }
+
+    paintRubberBand(p);
+}
+#else
+GraphWidget::~GraphWidget()
+{
+    releaseGL();
+}
+
+// The GL objects belong to the context, so they go with it; a new context
+// gets a new initializeGL
+void GraphWidget::releaseGL()
+{
+    makeCurrent();
+    glRenderer.release();
+    doneCurrent();
+}
+
+void GraphWidget::initializeGL()
+{
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, &GraphWidget::releaseGL);
+    glRenderer.initialize();
+    glSceneDirty = true;
+}
+
+// Edges and nodes come from the GPU; the selection halo and the labels,
+// few at the zooms where they show, are painted over them
+void GraphWidget::paintGL()
+{
+    syncSceneIndex();
+    if (glSceneDirty || glRenderer.nodeCount() != static_cast<int>(nodes.size())) {
+        glRenderer.upload(nodes, sceneIndex.edgeList());
+        glSceneDirty = false;
+    } else if (glChanged.all || !glChanged.ids.empty()) {
+        glRenderer.update(nodes, glChanged.all ? nullptr : &glChanged.ids);
+    }
+    glChanged.clear();
+
+    QPainter p(this);
+    p.beginNativePainting();
+    glRenderer.render(width(), height(), devicePixelRatioF(), zoom, offsetX, offsetY);
+    p.endNativePainting();
+
+    p.setRenderHint(QPainter::Antialiasing);
     p.translate(offsetX, offsetY);
     p.scale(zoom, zoom);
 
+    const bool labels = zoom >= LabelMinZoom;
+    const double reachX = labels ? LabelReachX : HaloReach, reachY = labels ? LabelReachY : HaloReach;
+    QPointF topLeft = screenToGraph(QPointF(0, 0), zoom, offsetX, offsetY);
+    QPointF bottomRight = screenToGraph(QPointF(width(), height()), zoom, offsetX, offsetY);
+    visibleNodes.clear();
+    sceneIndex.nodesInBox(topLeft.x() - reachX, topLeft.y() - HaloReach,
+                          bottomRight.x() + HaloReach, bottomRight.y() + reachY, visibleNodes);
+    std::sort(visibleNodes.begin(), visibleNodes.end());
+
+    for (int i : visibleNodes)
+        if (isSelected(i)) paintNode(p, i);
+
+    if (labels) {
+        p.setPen(Qt::black);
+        for (int i : visibleNodes) paintLabel(p, i);
+    }
+
+    paintRubberBand(p);
+}
+#endif
+
+// Edges, nodes and labels that can reach the viewport, except node skip
+// and its edges. The painter is already in graph coordinates
+void GraphWidget::paintScene(QPainter &p, int skip)
+{
+    // Only what can reach the viewport is drawn: the visible rectangle in
+    // graph coordinates, looked up in the scene index
+    QPointF topLeft = screenToGraph(QPointF(0, 0), zoom, offsetX, offsetY);
+    QPointF bottomRight = screenToGraph(QPointF(width(), height()), zoom, offsetX, offsetY);
+
     // ------------------------
-    // Draw edges
+    // Draw edges, one batch
     // ------------------------
+    const double penReach = 2;
+    visibleEdges.clear();
+    sceneIndex.edgesInBox(topLeft.x() - penReach, topLeft.y() - penReach,
+                          bottomRight.x() + penReach, bottomRight.y() + penReach, visibleEdges);
+
+    const auto &edges = sceneIndex.edgeList();
+    edgeLines.clear();
+    for (int e : visibleEdges) {
+        if (edges[e].first == skip || edges[e].second == skip) continue;
+        const auto &a = nodes[edges[e].first];
+        const auto &b = nodes[edges[e].second];
+        edgeLines.push_back(QLineF(a.x, a.y, b.x, b.y));
+    }
     p.setPen(QPen(Qt::darkGray, 2));
-
-    for (int i = 0; i < adj.size(); ++i)
-        for (int neigh : adj[i]) {
-            if (i < neigh) {
-                const auto &a = nodes[i];
-                const auto &b = nodes[neigh];
-                p.drawLine(QPointF(a.x, a.y), QPointF(b.x, b.y));
-            }
-        }
+    p.drawLines(edgeLines.data(), static_cast<int>(edgeLines.size()));
 
     // ------------------------
     // Draw nodes (with halo)
     // ------------------------
-    for (int i = 0; i < nodes.size(); i++) {
-        const auto &pt = nodes[i];
+    const bool labels = zoom >= LabelMinZoom;
+    const double reachX = labels ? LabelReachX : HaloReach, reachY = labels ? LabelReachY : HaloReach;
+    visibleNodes.clear();
+    sceneIndex.nodesInBox(topLeft.x() - reachX, topLeft.y() - HaloReach,
+                          bottomRight.x() + HaloReach, bottomRight.y() + reachY, visibleNodes);
+
+    // Grouped by fill and border, so each group sets the pen and brush
+    // once; selected nodes go on top of all of them
+    auto colorKey = [this](int i) {
+        return std::make_pair(nodes[i].color.rgba(), nodes[i].colorBorder.rgba());
+    };
+    std::sort(visibleNodes.begin(), visibleNodes.end(), [&](int a, int b) {
+        auto ka = colorKey(a), kb = colorKey(b);
+        return ka != kb ? ka < kb : a < b;
+    });
 
-        if (i == selectedNode) {
+    selectedVisible.clear();
+    for (size_t k = 0; k < visibleNodes.size(); ) {
+        const auto &first = nodes[visibleNodes[k]];
+        p.setPen(first.colorBorder);
+        p.setBrush(first.color);
+        const auto key = colorKey(visibleNodes[k]);
+        for (; k < visibleNodes.size() && colorKey(visibleNodes[k]) == key; ++k) {
+            const int i = visibleNodes[k];
+            if (i == skip) continue;
+            if (isSelected(i)) { selectedVisible.push_back(i); continue; }
+            p.drawEllipse(QPointF(nodes[i].x, nodes[i].y), 5, 5);
+        }
+    }
+    std::sort(selectedVisible.begin(), selectedVisible.end());
+    for (int i : selectedVisible) paintNode(p, i);
 
-            // Outer blue glow
-            p.setPen(QPen(QColor(0, 120, 255, 180), 6));
-            p.setBrush(Qt::NoBrush);
-            p.drawEllipse(QPointF(pt.x, pt.y), 12, 12);
+    if (!labels) return;
 
-            // inner white ring
-            p.setPen(QPen(Qt::white, 3));
-            p.setBrush(Qt::NoBrush);
-            p.drawEllipse(QPointF(pt.x, pt.y), 8, 8);
+    p.setPen(Qt::black);
+    for (int i : visibleNodes)
+        if (i != skip) paintLabel(p, i);
+}
 
-            // actual node
-            p.setPen(pt.colorBorder);
-            p.setBrush(pt.color);
-            p.drawEllipse(QPointF(pt.x, pt.y), 6, 6);
-        }
-        else {
-            p.setPen(pt.colorBorder);
-            p.setBrush(pt.color);
-            p.drawEllipse(QPointF(pt.x, pt.y), 5, 5);
-        }
-        p.setPen(Qt::black);
+void GraphWidget::paintNode(QPainter &p, int i)
+{
+    const auto &pt = nodes[i];
+
+    if (isSelected(i)) {
+
+        // Outer blue glow
+        p.setPen(QPen(QColor(0, 120, 255, 180), 6));
+        p.setBrush(Qt::NoBrush);
+        p.drawEllipse(QPointF(pt.x, pt.y), 12, 12);
+
+        // inner white ring
+        p.setPen(QPen(Qt::white, 3));
         p.setBrush(Qt::NoBrush);
-        p.setFont(QFont("Arial", 10));
+        p.drawEllipse(QPointF(pt.x, pt.y), 8, 8);
 
+        // actual node
+        p.setPen(pt.colorBorder);
+        p.setBrush(pt.color);
+        p.drawEllipse(QPointF(pt.x, pt.y), 6, 6);
+    }
+    else {
+        p.setPen(pt.colorBorder);
+        p.setBrush(pt.color);
+        p.drawEllipse(QPointF(pt.x, pt.y), 5, 5);
+    }
+}
+
+// Labels are laid out once per name and kept as QStaticText; the pen
+// is the caller's
+void GraphWidget::paintLabel(QPainter &p, int i)
+{
+    const auto &pt = nodes[i];
+
+    if (labelCache.size() < nodes.size()) {
+        labelCache.resize(nodes.size());
+        labelSource.resize(nodes.size());
+        labelReady.resize(nodes.size(), false);
+    }
+    if (!labelReady[i] || labelSource[i] != pt.name) {
         QString label = (pt.name.isEmpty()
                             ? QString("Node ") + QString::number(i)
                             : pt.name);
+        labelCache[i] = QStaticText(label);
+        labelCache[i].setPerformanceHint(QStaticText::AggressiveCaching);
+        labelCache[i].prepare(QTransform(), labelFont);
+        labelSource[i] = pt.name;
+        labelReady[i] = true;
+    }
 
-        p.drawText(QPointF(pt.x + 8, pt.y - 8), label);
+    // drawText took the baseline, drawStaticText takes the top left
+    p.setFont(labelFont);
+    p.drawStaticText(QPointF(pt.x + 8, pt.y - 8 - labelAscent), labelCache[i]);
+}
 
+void GraphWidget::paintRubberBand(QPainter &p)
+{
+    if (!rubberBanding) return;
 
-    }
+    p.resetTransform();
+    p.setPen(QPen(QColor(0, 120, 255), 1, Qt::DashLine));
+    p.setBrush(QColor(0, 120, 255, 40));
+    p.drawRect(QRectF(rubberStart, rubberEnd).normalized());
+}
+
+bool GraphWidget::isSelected(int i) const
+{
+    return i == selectedNode || (i >= 0 && i < static_cast<int>(selectionMask.size()) && selectionMask[i]);
+}
+
+void GraphWidget::setSelection(const std::vector<int> &ids)
+{
+    selection.clear();
+    selectionMask.assign(nodes.size(), false);
+    for (int i : ids)
+        if (i >= 0 && i < static_cast<int>(nodes.size()) && !selectionMask[i]) {
+            selectionMask[i] = true;
+            selection.push_back(i);
+        }
+    std::sort(selection.begin(), selection.end());
+    layerDirty = true;
+    update();
+    emit selectionChanged();
 }
 
 void GraphWidget::wheelEvent(QWheelEvent *event)
@@ -180,21 +564,41 @@ void GraphWidget::mousePressEvent(QMouseEvent *event)
 
     const double hitRadius = 10.0 / zoom;  // scale click radius with zoom
 
-    for (int i = 0; i < nodes.size(); i++) {
-        double dx = g.x() - nodes[i].x;
-        double dy = g.y() - nodes[i].y;
-        double dist = std::sqrt(dx*dx + dy*dy);
-
-        if (dist <= hitRadius) {
-            selectedNode = i;
-            draggedNodeIndex = i;
-            draggingNode = true;
-
-            dragOffsetGraph = QPointF(nodes[i].x - g.x(), nodes[i].y - g.y());
-
-            emit nodeClicked(i);
-            break;
+    // The index follows every paint; only a new node set or adjacency
+    // that has not been painted yet needs a rebuild here
+    if (sceneDirty || sceneIndex.nodeCount() != static_cast<int>(nodes.size()))
+        syncSceneIndex();
+    const int hit = sceneIndex.nearestNode(g.x(), g.y(), hitRadius);
+    const bool shift = event->modifiers().testFlag(Qt::ShiftModifier);
+
+    if (hit >= 0) {
+        draggedNodeIndex = hit;
+        draggingNode = true;
+
+        dragOffsetGraph = QPointF(nodes[hit].x - g.x(), nodes[hit].y - g.y());
+
+        // Shift-click adds the node to the selection or takes it out
+        if (shift) {
+            std::vector<int> ids = selection;
+            auto it = std::find(ids.begin(), ids.end(), hit);
+            if (it != ids.end()) ids.erase(it);
+            else ids.push_back(hit);
+            setSelection(ids);
+            if (isSelected(hit)) selectedNode = hit;
+        } else {
+            if (hit >= static_cast<int>(selectionMask.size()) || !selectionMask[hit])
+                setSelection({});
+            selectedNode = hit;
         }
+
+        emit nodeClicked(hit);
+    } else if (shift) {
+        // Shift-drag on empty space selects a rectangle instead of panning
+        dragging = false;
+        rubberBanding = true;
+        rubberStart = rubberEnd = event->position();
+    } else if (!selection.empty()) {
+        setSelection({});
     }
 
     update();
@@ -210,13 +614,19 @@ void GraphWidget::mouseMoveEvent(QMouseEvent *event)
         nodes[draggedNodeIndex].x = g.x() + dragOffsetGraph.x();
         nodes[draggedNodeIndex].y = g.y() + dragOffsetGraph.y();
 
-        update();
+        nodesChanged(draggedNodeIndex);
 
-        emit nodeMoved();   // <---- ADD THIS
+        emit nodeMoved(draggedNodeIndex);
 
         return;
     }
 
+    if (rubberBanding) {
+        rubberEnd = event->position();
+        update();
+        return;
+    }
+
     // Otherwise: pan
     if (dragging) {
         QPoint delta = event->pos() - lastMousePos;
@@ -235,6 +645,22 @@ void GraphWidget::mouseReleaseEvent(QMouseEvent *event)
     draggingNode = false;
     draggedNodeIndex = -1;
 
+    if (rubberBanding) {
+        rubberBanding = false;
+        QRectF r = QRectF(screenToGraph(rubberStart, zoom, offsetX, offsetY),
+                          screenToGraph(rubberEnd, zoom, offsetX, offsetY)).normalized();
+        syncSceneIndex();
+        std::vector<int> ids = selection;
+        sceneIndex.nodesInBox(r.left(), r.top(), r.right(), r.bottom(), ids);
+        setSelection(ids);
+    }
+
+    if (clustersStale && !animating) {
+        clustersDirty = true;
+        update();
+    }
+    staticLayer = QPixmap();
+
     emit nodeReleased();
 }
 
@@ -3,7 +3,22 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QEasingCurve>
+#include <QPainter>
+#include <QPixmap>
+#include <QStaticText>
 #include <vector>
+#include "sceneindex.h"
+#include "clustertree.h"
+
+// CLARITY_OPENGL builds draw through OpenGL (see graphglrenderer.h); the
+// interaction, culling and labels are shared with the raster widget
+#ifdef CLARITY_OPENGL
+#include <QOpenGLWidget>
+#include "graphglrenderer.h"
+using GraphWidgetBase = QOpenGLWidget;
+#else
+using GraphWidgetBase = QWidget;
+#endif
 
 struct NodeInfo {
     double x = 0, y = 0;
@@ -40,10 +55,13 @@ struct NodeInfo {
     }
 };
 
-class GraphWidget : public QWidget {
+class GraphWidget : public GraphWidgetBase {
     Q_OBJECT
 public:
     explicit GraphWidget(QWidget *parent = nullptr);
+#ifdef CLARITY_OPENGL
+    ~GraphWidget() override;
+#endif
 
     void setNodes(const std::vector<NodeInfo> &pts);
     void setAdjacency(const std::vector<std::vector<int>> &g);
@@ -51,8 +69,28 @@ public:
     // Start smooth animation to target positions (graph coordinates)
     void animateTo(const std::vector<QPointF> &targets, int durationMs = 400);
 
+    // Position or colours of node index, or of every node with -1, were
+    // written into nodes directly. Paints only look at the nodes reported
+    // here, so a frame costs what is visible rather than a pass over all
+    void nodesChanged(int index = -1);
+
 protected:
+    // Nodes written since a consumer last caught up: their ids, or all of
+    // them once a quarter of the nodes are in (a rebuild is cheaper then)
+    struct ChangedNodes {
+        std::vector<int> ids;
+        bool all = false;
+        void add(int index, int nodeCount);
+        void clear() { ids.clear(); all = false; }
+    };
+
+#ifdef CLARITY_OPENGL
+    void initializeGL() override;
+    void paintGL() override;
+    void releaseGL();
+#else
     void paintEvent(QPaintEvent *event) override;
+#endif
 
     // Zoom & pan
     void wheelEvent(QWheelEvent *event) override;
@@ -64,15 +102,32 @@ public:
     std::vector<NodeInfo> nodes;
     std::vector<std::vector<int>> adj;
 
+    // Level of detail: labels go below LabelMinZoom; below AggregateMaxZoom
+    // a large graph is drawn as one glyph per ClusterCellPx screen cell
+    static constexpr double LabelMinZoom = 0.6;
+    static constexpr double AggregateMaxZoom = 0.5;
+    static constexpr double ClusterCellPx = 8;
+    static const int AggregateMinNodes = 2000;
+
     double zoom = 1.0;
     double offsetX = 0;
     double offsetY = 0;
 
     int selectedNode = -1;
 
+    // Multi-selection, sorted ids: shift-click toggles a node, shift-drag
+    // on empty space adds the nodes inside the rectangle
+    std::vector<int> selection;
+    void setSelection(const std::vector<int> &ids);
+    bool isSelected(int i) const;   // selectedNode or in selection
+    void resetSelection();          // setNodes and setAdjacency call it
+
     bool dragging = false;
     QPoint lastMousePos;
 
+    bool rubberBanding = false;
+    QPointF rubberStart, rubberEnd;   // widget coordinates
+
     bool draggingNode = false;
     int draggedNodeIndex = -1;
     QPointF dragOffsetGraph;
@@ -87,8 +142,54 @@ public:
 
     QPointF screenToGraph(const QPointF &p, double zoom, double offsetX, double offsetY);
 
+private:
+    // Brings sceneIndex up to date with nodes/adj; nodes is edited in
+    // place (drag, animation, MainWindow), so positions are diffed here
+    void syncSceneIndex();
+
+    void paintScene(QPainter &p, int skip);
+    void paintNode(QPainter &p, int i);
+    void paintLabel(QPainter &p, int i);
+    void paintClusters(QPainter &p, const QPointF &topLeft, const QPointF &bottomRight);
+    void paintRubberBand(QPainter &p);
+
+    SceneIndex sceneIndex;
+    bool sceneDirty = true;      // adjacency or node set changed: rebuild
+    ChangedNodes sceneChanged;   // to move in the index
+
+    // Rebuilt on the next aggregated paint when dirty. A drag or an
+    // animation only marks it stale, and the rebuild waits for the release
+    // or the last frame
+    ClusterTree clusterTree;
+    bool clustersDirty = true;
+    bool clustersStale = false;
+    std::vector<int> visibleEdges, visibleNodes, selectedVisible;
+    std::vector<bool> selectionMask;
+    std::vector<QLineF> edgeLines;
+
+    // Label layouts by node, redone when the name changes
+    QFont labelFont;
+    double labelAscent = 0;
+    std::vector<QStaticText> labelCache;
+    std::vector<QString> labelSource;
+    std::vector<bool> labelReady;
+
+    // Everything but the dragged node and its edges, at the view it was
+    // drawn for; dropped on release
+    QPixmap staticLayer;
+    bool layerDirty = true;
+    int layerNode = -1;
+    double layerZoom = 0, layerOffsetX = 0, layerOffsetY = 0;
+
+#ifdef CLARITY_OPENGL
+    GraphGLRenderer glRenderer;
+    bool glSceneDirty = true;    // node set or adjacency changed: upload
+    ChangedNodes glChanged;      // to rewrite in the instance buffers
+#endif
+
 signals:
     void nodeClicked(int index);   // used to sync with node list
-    void nodeMoved();
+    void nodeMoved(int index);     // dragged node, or -1 when many nodes moved
     void nodeReleased();
+    void selectionChanged();
 };
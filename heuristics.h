@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "csrgraph.h"
+#include "solver.h"
+
+// Building blocks of Solver::computeLayout, for tools that time or combine
+// them one by one. Assignments map vertex -> index into the coords grid.
+
+bool isPlanar(const CsrGraph& graph);
+
+// Crossing-free straight-line drawing of a planar graph on the integer
+// (2V-4) x (V-2) grid; empty if the graph is not planar
+std::vector<std::pair<double, double>> planar_straight_line_drawing(const CsrGraph& graph);
+int k_small(long long V, long long E);
+
+// Candidate grid for V vertices: side length and jittered points (row-major)
+int grid_side(int V);
+std::vector<std::pair<double, double>> perturbed_grid(int r, unsigned seed);
+double target_distance(int V, int E);
+
+// Grid indices of an r x r grid, from the outer ring inwards
+std::vector<int> spiralOrder(int r);
+
+std::vector<int> spiral_assignment(int V, const std::vector<int>& spiral);
+
+std::vector<int> degree_greedy_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<int>& position_order);
+
+std::vector<int> barycentric_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<int>& position_order);
+
+// Barycenter of the placed neighbours' coords, nearest free cell in 2D.
+// Once cancelled, the rest of the vertices follow position_order.
+std::vector<int> barycentric_2d_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<std::pair<double, double>>& coords,
+    const std::vector<int>& position_order,
+    const SolverControl& control = SolverControl());
+
+std::vector<int> distance_refinement_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<int>& initial_assignment,
+    const std::vector<std::pair<double, double>>& coords,
+    double target_d,
+    int r,
+    unsigned seed,
+    const SolverControl& control);
+
+// Multilevel: matchings coarsen the graph to a few dozen vertices, the 2D
+// barycentric placement and refinement lay that out, then every level is
+// projected onto a finer grid and swept; the last level lands on coords
+std::vector<int> multilevel_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<std::pair<double, double>>& coords,
+    int r,
+    unsigned seed,
+    const SolverControl& control);
+
+// Force-directed drawing with Barnes-Hut repulsion (O(V log V) per
+// iteration), stretched over the grid and snapped to the nearest free cells
+std::vector<int> force_directed_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<std::pair<double, double>>& coords,
+    int r,
+    unsigned seed,
+    const SolverControl& control);
+
+// Simulated annealing on the crossing count, from initial_assignment.
+// Moves relocate a vertex into a nearby empty cell or swap it with the
+// occupant; the delta comes from the moved vertices' edges against an
+// EdgeIndex. Returns the best layout seen within timeBudgetMs.
+const int AnnealingTimeLimitMs = 3000;
+
+std::vector<int> annealing_assignment(
+    int V,
+    const CsrGraph& g,
+    const std::vector<int>& initial_assignment,
+    const std::vector<std::pair<double, double>>& coords,
+    int r,
+    unsigned seed,
+    int timeBudgetMs,
+    const SolverControl& control);
+
+// Exact search on the first V grid points for V <= ExactMaxVertices.
+// Returns a layout with fewer than upperBound crossings, or an empty vector.
+const int ExactMaxVertices = 16;
+const int ExactTimeLimitMs = 2000;
+
+std::vector<int> branch_and_bound_layout(
+    int V,
+    const CsrGraph& g,
+    const std::vector<std::pair<double, double>>& coords,
+    int upperBound,
+    const SolverControl& control,
+    int timeLimitMs = ExactTimeLimitMs);
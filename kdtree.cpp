@@ -0,0 +1,86 @@
+#include "kdtree.h"
+#include <algorithm>
+
+using namespace std;
+
+// Implicit layout: the subtree over slots [lo, hi) is rooted at
+// mid = (lo + hi) / 2 and splits on x at even depths, on y at odd ones.
+
+KdTree::KdTree(const vector<pair<double,double>>& points)
+    : pts(points), node(points.size()), slotOf(points.size()),
+      count(points.size()), here(points.size(), 1), present((int)points.size())
+{
+    for (int i = 0; i < (int)node.size(); i++) node[i] = i;
+    build(0, (int)node.size(), 0);
+    for (int s = 0; s < (int)node.size(); s++) slotOf[node[s]] = s;
+}
+
+void KdTree::build(int lo, int hi, int depth)
+{
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    bool byX = depth % 2 == 0;
+    nth_element(node.begin() + lo, node.begin() + mid, node.begin() + hi,
+                [&](int a, int b) {
+                    double ka = byX ? pts[a].first : pts[a].second;
+                    double kb = byX ? pts[b].first : pts[b].second;
+                    return ka < kb || (ka == kb && a < b);
+                });
+    count[mid] = hi - lo;
+    build(lo, mid, depth + 1);
+    build(mid + 1, hi, depth + 1);
+}
+
+void KdTree::remove(int i)
+{
+    if (!contains(i)) return;
+    here[i] = 0;
+    present--;
+
+    int target = slotOf[i];
+    int lo = 0, hi = (int)node.size();
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        count[mid]--;
+        if (target == mid) break;
+        if (target < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+int KdTree::nearest(double x, double y, double maxDist) const
+{
+    int best = -1;
+    double bestDist = maxDist * maxDist;
+    search(0, (int)node.size(), 0, x, y, best, bestDist);
+    return best;
+}
+
+void KdTree::search(int lo, int hi, int depth, double x, double y,
+                    int& best, double& bestDist) const
+{
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    if (count[mid] == 0) return;
+
+    int p = node[mid];
+    if (here[p]) {
+        double dx = pts[p].first - x, dy = pts[p].second - y;
+        double d = dx * dx + dy * dy;
+        if (d < bestDist || (d == bestDist && (best < 0 || p < best))) {
+            best = p;
+            bestDist = d;
+        }
+    }
+
+    double diff = (depth % 2 == 0) ? x - pts[p].first : y - pts[p].second;
+    bool leftFirst = diff < 0;
+    if (leftFirst) search(lo, mid, depth + 1, x, y, best, bestDist);
+    else           search(mid + 1, hi, depth + 1, x, y, best, bestDist);
+
+    // The far side can only help if the splitting line is within reach
+    if (diff * diff <= bestDist) {
+        if (leftFirst) search(mid + 1, hi, depth + 1, x, y, best, bestDist);
+        else           search(lo, mid, depth + 1, x, y, best, bestDist);
+    }
+}
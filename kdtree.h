@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <limits>
+
+// Static 2D k-d tree over a point set with removal. Each subtree keeps the
+// number of points still present, so nearest() skips emptied subtrees.
+// Build O(n log n), remove() O(log n), nearest() about O(log n).
+class KdTree {
+public:
+    explicit KdTree(const std::vector<std::pair<double, double>>& points);
+
+    int size() const { return present; }
+    bool contains(int i) const { return i >= 0 && i < (int)pts.size() && here[i]; }
+
+    void remove(int i);
+
+    // Closest present point to (x, y), lowest index on ties; -1 if none is
+    // within maxDist. A finite maxDist bounds the search when the area
+    // around (x, y) has been emptied.
+    int nearest(double x, double y,
+                double maxDist = std::numeric_limits<double>::infinity()) const;
+
+private:
+    void build(int lo, int hi, int depth);
+    void search(int lo, int hi, int depth, double x, double y,
+                int& best, double& bestDist) const;
+
+    std::vector<std::pair<double, double>> pts;
+    std::vector<int> node;      // point stored at each tree slot
+    std::vector<int> slotOf;    // point -> slot
+    std::vector<int> count;     // present points in the subtree rooted at a slot
+    std::vector<char> here;
+    int present = 0;
+};
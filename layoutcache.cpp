@@ -0,0 +1,218 @@
+#include "layoutcache.h"
+#include "solver.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Layout files: magic, layout version, check hash, k, vertex count, then
+// x y per vertex
+const char FileMagic[8] = {'C', 'G', 'L', 'A', 'Y', 'O', 'U', '2'};
+
+// The oldest files go once the directory holds more than this many
+const int MaxFiles = 256;
+
+// Vertex count past which a layout file is taken for corrupt
+const int MaxFileVertices = 1 << 24;
+
+// splitmix64 finalizer, folded over the values one by one
+struct Hasher {
+    uint64_t h;
+    explicit Hasher(uint64_t seed) : h(seed) {}
+    void add(uint64_t x)
+    {
+        uint64_t z = h ^ (x + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2));
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        h = z ^ (z >> 31);
+    }
+};
+
+} // namespace
+
+LayoutCache::Key LayoutCache::keyOf(const vector<vector<int>>& adj, int V, int E,
+                                    int heuristicIndex, unsigned seed, int runs,
+                                    int budgetMs)
+{
+    // The neighbour lists CsrGraph builds: out-of-range ids dropped, the
+    // rest in order, parallel copies and loops included
+    const int n = max(0, min(V, (int)adj.size()));
+
+    Hasher a(0x636C6172697479ull), b(0x677261706873ull);
+    for (Hasher* h : {&a, &b}) {
+        h->add((uint64_t)V);
+        h->add((uint64_t)E);
+        h->add((uint64_t)heuristicIndex);
+        h->add((uint64_t)seed);
+        h->add((uint64_t)runs);
+        h->add((uint64_t)budgetMs);
+        h->add((uint64_t)Solver::LayoutVersion);
+    }
+    for (int u = 0; u < n; u++) {
+        // Degree first, so the lists cannot run into each other
+        uint64_t degree = 0;
+        for (int v : adj[u])
+            if (v >= 0 && v < n) degree++;
+        a.add(degree);
+        b.add(degree);
+        for (int v : adj[u]) {
+            if (v < 0 || v >= n) continue;
+            a.add((uint64_t)v);
+            b.add((uint64_t)v);
+        }
+    }
+    return Key{a.h, b.h, V};
+}
+
+LayoutCache::LayoutCache(int capacity)
+    : capacity(max(1, capacity))
+{
+}
+
+void LayoutCache::setDirectory(const string& path)
+{
+    lock_guard<std::mutex> lock(guard);
+    directory = path;
+}
+
+LayoutCache::Stats LayoutCache::stats() const
+{
+    lock_guard<std::mutex> lock(guard);
+    return counts;
+}
+
+bool LayoutCache::find(const Key& key, Layout& out)
+{
+    lock_guard<std::mutex> lock(guard);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        out = it->second->second;
+        counts.memoryHits++;
+        return true;
+    }
+    if (!directory.empty() && load(directory, key, out)) {
+        remember(key, out);
+        counts.diskHits++;
+        return true;
+    }
+    counts.misses++;
+    return false;
+}
+
+// The file is written outside the lock, so lookups never wait for it
+void LayoutCache::store(const Key& key, const Layout& layout)
+{
+    string dir;
+    {
+        lock_guard<std::mutex> lock(guard);
+        remember(key, layout);
+        dir = directory;
+    }
+    if (!dir.empty()) save(dir, key, layout);
+}
+
+void LayoutCache::remember(const Key& key, const Layout& layout)
+{
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = layout;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    entries.emplace_front(key, layout);
+    index[key] = entries.begin();
+    if ((int)entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+string LayoutCache::fileOf(const string& dir, const Key& key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.layout", (unsigned long long)key.id);
+    return (fs::path(dir) / name).string();
+}
+
+bool LayoutCache::load(const string& dir, const Key& key, Layout& out)
+{
+    ifstream in(fileOf(dir, key), ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(FileMagic)];
+    uint32_t version = 0;
+    uint64_t check = 0;
+    int32_t k = 0, n = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&check), sizeof(check));
+    in.read(reinterpret_cast<char*>(&k), sizeof(k));
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    if (!in || !equal(magic, magic + sizeof(magic), FileMagic)
+        || version != Solver::LayoutVersion || check != key.check
+        || n != key.vertices || n < 0 || n > MaxFileVertices)
+        return false;
+
+    vector<pair<double,double>> coords(n);
+    for (auto& p : coords) {
+        in.read(reinterpret_cast<char*>(&p.first), sizeof(double));
+        in.read(reinterpret_cast<char*>(&p.second), sizeof(double));
+    }
+    if (!in) return false;
+
+    out = {k, std::move(coords)};
+    return true;
+}
+
+// Failures are ignored: the disk store is only a cache
+void LayoutCache::save(const string& dir, const Key& key, const Layout& layout)
+{
+    error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) return;
+
+    {
+        // Written under a temporary name, so a reader never sees half a file
+        const string path = fileOf(dir, key);
+        const string partial = path + "." + to_string(hash<thread::id>()(this_thread::get_id())) + ".part";
+        ofstream out(partial, ios::binary | ios::trunc);
+        if (!out) return;
+        const uint32_t version = Solver::LayoutVersion;
+        int32_t k = layout.first, n = (int32_t)layout.second.size();
+        out.write(FileMagic, sizeof(FileMagic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&key.check), sizeof(key.check));
+        out.write(reinterpret_cast<const char*>(&k), sizeof(k));
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        for (const auto& p : layout.second) {
+            out.write(reinterpret_cast<const char*>(&p.first), sizeof(double));
+            out.write(reinterpret_cast<const char*>(&p.second), sizeof(double));
+        }
+        out.close();
+        if (!out) {
+            fs::remove(partial, ec);
+            return;
+        }
+        fs::rename(partial, path, ec);
+    }
+
+    // Keep the directory bounded: drop the least recently written files
+    try {
+        vector<pair<fs::file_time_type, fs::path>> files;
+        for (const auto& entry : fs::directory_iterator(dir))
+            if (entry.path().extension() == ".layout")
+                files.emplace_back(entry.last_write_time(), entry.path());
+        if ((int)files.size() <= MaxFiles) return;
+        sort(files.begin(), files.end());
+        for (size_t i = 0; i + MaxFiles < files.size(); i++)
+            fs::remove(files[i].second, ec);
+    } catch (const fs::filesystem_error&) {
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+// Finished layouts keyed by graph and solve settings: an in-memory LRU,
+// optionally backed by one file per layout in a directory.
+// All members are safe to call from several threads.
+class LayoutCache {
+public:
+    using Layout = std::pair<int, std::vector<std::pair<double, double>>>;   // k, coords
+
+    // Two independent 64-bit hashes; the second one guards against
+    // collisions of the first, which names the entry. vertices is hashed
+    // too and bounds what a layout file may hold
+    struct Key {
+        std::uint64_t id = 0;
+        std::uint64_t check = 0;
+        int vertices = 0;
+        bool operator==(const Key& o) const { return id == o.id && check == o.check; }
+    };
+
+    struct Stats {
+        long long memoryHits = 0;
+        long long diskHits = 0;
+        long long misses = 0;
+    };
+
+    // Hash of the adjacency as CsrGraph reads it (neighbour order and
+    // parallel edges kept, since the solver sees both), V, E, the heuristic,
+    // the seed and Solver::LayoutVersion. runs and budgetMs tell solves with
+    // different settings apart: seeded runs of a multi-start (0 for an
+    // anytime solve) and its wall-clock budget.
+    static Key keyOf(const std::vector<std::vector<int>>& adj, int V, int E,
+                     int heuristicIndex, unsigned seed, int runs = 1,
+                     int budgetMs = 0);
+
+    explicit LayoutCache(int capacity = 32);
+
+    // Empty directory: memory only. The directory is created on first store.
+    void setDirectory(const std::string& path);
+
+    // Memory first, then disk; a disk hit is kept in memory too
+    bool find(const Key& key, Layout& out);
+    void store(const Key& key, const Layout& layout);
+
+    Stats stats() const;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const { return (std::size_t)k.id; }
+    };
+    using Entry = std::pair<Key, Layout>;
+
+    static std::string fileOf(const std::string& dir, const Key& key);
+    static bool load(const std::string& dir, const Key& key, Layout& out);
+    static void save(const std::string& dir, const Key& key, const Layout& layout);
+    void remember(const Key& key, const Layout& layout);   // caller holds guard
+
+    mutable std::mutex guard;
+    int capacity;
+    std::list<Entry> entries;                                   // most recent first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::string directory;
+    Stats counts;
+};
@@ -0,0 +1,246 @@
+#include "solver.h"
+#include "crossings.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <chrono>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Headless layout tool: project files in, positions and stats out.
+// Reads the JSON written by MainWindow::autoSave / Save Project.
+//------------------------------------------------------------
+
+namespace {
+
+// Same mapping from solver grid units to scene coordinates as applyLayout()
+const double LayoutScale = 60.0;
+const double LayoutOffset = 80.0;
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start)
+{
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+struct Project {
+    QJsonObject root;
+    int V = 0;
+    int E = 0;
+    vector<vector<int>> adj;
+};
+
+// Same rules as the import in MainWindow: "nodes" is required, edges are
+// [u, v] pairs and out-of-range pairs are skipped
+bool loadProject(const QString &path, Project &project, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "cannot open file";
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        error = "invalid JSON: " + parseError.errorString();
+        return false;
+    }
+
+    project.root = doc.object();
+    if (!project.root.value("nodes").isArray()) {
+        error = "JSON missing 'nodes'";
+        return false;
+    }
+
+    project.V = project.root.value("nodes").toArray().size();
+    project.adj.assign(project.V, {});
+    project.E = 0;
+
+    const QJsonArray edgeArr = project.root.value("edges").toArray();
+    for (const auto &eRef : edgeArr) {
+        QJsonArray e = eRef.toArray();
+        if (e.size() != 2) continue;
+        int u = e[0].toInt(-1);
+        int v = e[1].toInt(-1);
+        if (u < 0 || v < 0 || u >= project.V || v >= project.V) continue;
+        project.adj[u].push_back(v);
+        project.adj[v].push_back(u);
+        project.E++;
+    }
+    return true;
+}
+
+bool saveProject(const QString &path, const QJsonObject &root)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+// Selector index or short name, -1 if unknown
+int parseHeuristic(const QString &text)
+{
+    bool isNumber = false;
+    int index = text.toInt(&isNumber);
+    if (isNumber)
+        return (index >= 0 && index < Solver::HeuristicCount) ? index : -1;
+
+    for (int i = 0; i < Solver::HeuristicCount; i++)
+        if (text.compare(Solver::heuristicName(i), Qt::CaseInsensitive) == 0)
+            return i;
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("clarity-layout");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Computes layouts for UI-ClarityGraph project files without a display.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("projects", "Project JSON files (autosave format).", "<project.json...>");
+
+    QStringList names;
+    for (int i = 0; i < Solver::HeuristicCount; i++) names << Solver::heuristicName(i);
+
+    QCommandLineOption heuristicOption({"H", "heuristic"},
+        "Layout heuristic: " + names.join(", ") + " or the selector index.", "name", "best");
+    QCommandLineOption runsOption("runs", "Seeded runs per project, the best one is kept.", "n", "1");
+    QCommandLineOption budgetOption("budget", "No new run starts after this many milliseconds.", "ms", "0");
+    QCommandLineOption deadlineOption("deadline",
+        "Anytime mode: best layout found within this many milliseconds (replaces --runs and --budget).", "ms");
+    QCommandLineOption outputOption({"o", "output"}, "Write the results to this file instead of stdout.", "file");
+    QCommandLineOption compactOption("compact", "Write compact instead of indented JSON.");
+    QCommandLineOption writeBackOption("write-back", "Store the new node positions in the project files.");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Print solver diagnostics on stderr.");
+    parser.addOptions({heuristicOption, runsOption, budgetOption, deadlineOption, outputOption,
+                       compactOption, writeBackOption, verboseOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) {
+        err << "No project files given.\n";
+        parser.showHelp(1);
+    }
+
+    const int heuristic = parseHeuristic(parser.value(heuristicOption));
+    if (heuristic < 0) {
+        err << "Unknown heuristic: " << parser.value(heuristicOption) << "\n";
+        return 1;
+    }
+    const int runs = qMax(1, parser.value(runsOption).toInt());
+    const int budgetMs = qMax(0, parser.value(budgetOption).toInt());
+    const bool anytime = parser.isSet(deadlineOption);
+    const int deadlineMs = qMax(0, parser.value(deadlineOption).toInt());
+    if (anytime && heuristic != Solver::BestHeuristic) {
+        err << "--deadline only works with the best heuristic\n";
+        return 1;
+    }
+    Solver::setVerbose(parser.isSet(verboseOption));
+
+    bool allOk = true;
+    QJsonArray results;
+
+    for (const QString &path : inputs) {
+        QJsonObject result;
+        result["file"] = path;
+        result["heuristic"] = Solver::heuristicName(heuristic);
+
+        auto start = Clock::now();
+        Project project;
+        QString error;
+        if (!loadProject(path, project, error)) {
+            result["error"] = error;
+            results.append(result);
+            allOk = false;
+            continue;
+        }
+        double loadMs = msSince(start);
+
+        start = Clock::now();
+        pair<int, vector<pair<double, double>>> solved;
+        if (project.V > 0 && anytime)
+            solved = Solver::computeAnytime(project.V, project.E, project.adj, deadlineMs);
+        else if (project.V > 0)
+            solved = Solver::computeMultiStart(project.V, project.E, project.adj,
+                                               heuristic, runs, budgetMs);
+        const auto &[k, layout] = solved;
+        double layoutMs = msSince(start);
+
+        vector<pair<double, double>> positions(layout.size());
+        for (size_t i = 0; i < layout.size(); i++)
+            positions[i] = {layout[i].first * LayoutScale + LayoutOffset,
+                            layout[i].second * LayoutScale + LayoutOffset};
+
+        start = Clock::now();
+        int crossings = CrossingCounter::count(positions, project.adj);
+        double crossingsMs = msSince(start);
+
+        QJsonArray positionArr;
+        for (const auto &p : positions)
+            positionArr.append(QJsonArray{p.first, p.second});
+
+        result["vertices"] = project.V;
+        result["edges"] = project.E;
+        result["k"] = k;
+        result["crossings"] = crossings;
+        result["positions"] = positionArr;
+        result["timings"] = QJsonObject{
+            {"loadMs", loadMs},
+            {"layoutMs", layoutMs},
+            {"crossingsMs", crossingsMs}
+        };
+
+        if (parser.isSet(writeBackOption) && (int)positions.size() == project.V) {
+            QJsonArray nodes = project.root.value("nodes").toArray();
+            for (int i = 0; i < project.V; i++) {
+                QJsonObject node = nodes[i].toObject();
+                node["x"] = positions[i].first;
+                node["y"] = positions[i].second;
+                nodes[i] = node;
+            }
+            project.root["nodes"] = nodes;
+            if (!saveProject(path, project.root)) {
+                result["error"] = "cannot write project back";
+                allOk = false;
+            }
+        }
+
+        results.append(result);
+    }
+
+    QJsonObject root;
+    root["results"] = results;
+    const QByteArray json = QJsonDocument(root).toJson(
+        parser.isSet(compactOption) ? QJsonDocument::Compact : QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption)) {
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            err << "Cannot write " << parser.value(outputOption) << "\n";
+            return 1;
+        }
+        out.write(json);
+    } else {
+        QFile out;
+        if (!out.open(stdout, QIODevice::WriteOnly))
+            return 1;
+        out.write(json);
+    }
+
+    return allOk ? 0 : 1;
+}
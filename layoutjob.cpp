@@ -0,0 +1,114 @@
+#include "layoutjob.h"
+#include "solver.h"
+#include <QMetaObject>
+
+LayoutJob::LayoutJob(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LayoutJob::~LayoutJob()
+{
+    cancel();
+    for (auto &w : workers)
+        if (w.thread.joinable()) w.thread.join();
+}
+
+void LayoutJob::cancel()
+{
+    for (auto &w : workers)
+        w.cancel->store(true);
+    ++generation;   // drop anything already queued
+    running = false;
+}
+
+// Join workers that already returned, never blocks the UI thread
+void LayoutJob::reap()
+{
+    for (auto it = workers.begin(); it != workers.end(); ) {
+        if (it->done->load()) {
+            it->thread.join();
+            it = workers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void LayoutJob::start(int V, int E, const std::vector<std::vector<int>> &adj, int heuristicIndex)
+{
+    const int runs = runCount;
+    const int timeBudgetMs = timeBudget;
+    launch(LayoutCache::keyOf(adj, V, E, heuristicIndex, Solver::DefaultSeed, runs, timeBudgetMs),
+           timeBudgetMs <= 0,
+           [V, E, adj, heuristicIndex, runs, timeBudgetMs](const SolverControl &control) {
+        return Solver::computeMultiStart(V, E, adj, heuristicIndex, runs, timeBudgetMs, control);
+    });
+}
+
+void LayoutJob::startAnytime(int V, int E, const std::vector<std::vector<int>> &adj, int budgetMs)
+{
+    launch(LayoutCache::keyOf(adj, V, E, Solver::BestHeuristic, Solver::DefaultSeed, 0, budgetMs),
+           false,
+           [V, E, adj, budgetMs](const SolverControl &control) {
+        return Solver::computeAnytime(V, E, adj, budgetMs, control);
+    });
+}
+
+void LayoutJob::launch(const LayoutCache::Key &key, bool cacheable, Solve solve)
+{
+    cancel();
+    reap();
+
+    const quint64 gen = generation;
+
+    // A cached layout is reported the same way as a solved one, queued
+    LayoutCache::Layout cached;
+    const bool hit = cacheable && cache.find(key, cached);
+    emit cacheChecked(hit);
+    if (hit) {
+        running = true;
+        QMetaObject::invokeMethod(this, [this, gen, cached]() {
+            if (gen != generation) return;
+            running = false;
+            if (!cached.second.empty()) emit finished(cached.first, cached.second);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    auto cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    auto doneFlag = std::make_shared<std::atomic<bool>>(false);
+    running = true;
+
+    std::thread t([this, gen, cancelFlag, doneFlag, key, cacheable, solve]() {
+        SolverControl control;
+        control.cancel = cancelFlag.get();
+        control.progress = [this, gen](int percent) {
+            QMetaObject::invokeMethod(this, [this, gen, percent]() {
+                if (gen == generation) emit progress(percent);
+            }, Qt::QueuedConnection);
+        };
+        control.improved = [this, gen](const std::vector<std::pair<double,double>> &layout, int) {
+            QMetaObject::invokeMethod(this, [this, gen, layout]() {
+                if (gen == generation) emit improved(layout);
+            }, Qt::QueuedConnection);
+        };
+
+        auto result = solve(control);
+        if (cacheable && !cancelFlag->load() && !result.second.empty())
+            cache.store(key, result);
+        int bestK = result.first;
+        std::vector<std::pair<double,double>> bestLayout = std::move(result.second);
+
+        if (!cancelFlag->load()) {
+            QMetaObject::invokeMethod(this, [this, gen, bestK, bestLayout]() {
+                if (gen != generation) return;
+                running = false;
+                if (!bestLayout.empty()) emit finished(bestK, bestLayout);
+            }, Qt::QueuedConnection);
+        }
+        doneFlag->store(true);
+    });
+
+    workers.push_back({std::move(t), cancelFlag, doneFlag});
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <QObject>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <string>
+#include "layoutcache.h"
+
+struct SolverControl;
+
+// Runs a multi-start or anytime Solver layout on a worker thread.
+// Starting a new job cancels the running one; only the newest job reports back.
+// Finished layouts are cached: asking again for an unchanged graph and
+// settings reports the cached layout without solving. Solves that a
+// wall-clock budget may have cut short depend on the machine and its load,
+// so they are neither looked up nor stored.
+class LayoutJob : public QObject {
+    Q_OBJECT
+public:
+    explicit LayoutJob(QObject *parent = nullptr);
+    ~LayoutJob();
+
+    void start(int V, int E, const std::vector<std::vector<int>> &adj, int heuristicIndex);
+
+    // Best layout within budgetMs; intermediate layouts arrive through improved()
+    void startAnytime(int V, int E, const std::vector<std::vector<int>> &adj, int budgetMs);
+    void cancel();
+    bool isRunning() const { return running; }
+
+    // Multi-start settings used by the next start(): number of seeds tried,
+    // and an optional wall-clock budget in ms (0 = run them all)
+    void setRuns(int runs) { runCount = runs < 1 ? 1 : runs; }
+    void setTimeBudget(int ms) { timeBudget = ms < 0 ? 0 : ms; }
+
+    // Where the cache keeps its layout files; empty keeps it in memory only
+    void setCacheDirectory(const std::string &dir) { cache.setDirectory(dir); }
+    LayoutCache::Stats cacheStats() const { return cache.stats(); }
+
+signals:
+    void progress(int percent);
+    void finished(int k, const std::vector<std::pair<double,double>> &layout);
+    void improved(const std::vector<std::pair<double,double>> &layout);
+    void cacheChecked(bool hit);   // once per start, before any result
+
+private:
+    using Solve = std::function<std::pair<int, std::vector<std::pair<double,double>>>(const SolverControl &)>;
+
+    struct Worker {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> cancel;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    void reap();
+    void launch(const LayoutCache::Key &key, bool cacheable, Solve solve);
+
+    std::vector<Worker> workers;
+    quint64 generation = 0;   // only touched on the UI thread
+    bool running = false;
+    int runCount = 3;
+    int timeBudget = 0;
+    LayoutCache cache;
+};
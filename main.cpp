@@ -1,12 +1,20 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#ifdef CLARITY_OPENGL
+#include "graphglrenderer.h"
+#endif
 
 int main(int argc, char *argv[])
 {
     // Avoid querying desktop portals for settings (prevents DBus warnings)
     // QApplication::setDesktopSettingsAware(false);
 
+#ifdef CLARITY_OPENGL
+    // Before the application: the shaders need GL 3.3 core or GLES 3.0
+    QSurfaceFormat::setDefaultFormat(GraphGLRenderer::requiredFormat());
+#endif
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -5,6 +5,8 @@
 #include "namedelegate.h"
 #include "RowNumberDelegate.h"
 #include "solver.h"
+#include "crossings.h"
+#include "layoutjob.h"
 
 #include <QTimer>
 #include <QDebug>
@@ -22,84 +24,54 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QToolBar>
-
-static bool segmentsIntersect(
-    QPointF A, QPointF B,
-    QPointF C, QPointF D)
-{
-    auto ccw = [](QPointF A, QPointF B, QPointF C) {
-        return (C.y() - A.y()) * (B.x() - A.x()) >
-               (B.y() - A.y()) * (C.x() - A.x());
-    };
-
-    return ccw(A,C,D) != ccw(B,C,D) &&
-           ccw(A,B,C) != ccw(A,B,D);
-}
+#include <QStatusBar>
 
 int MainWindow::countCrossings()
 {
-    int count = 0;
-
     auto &nodes = graphWidget->nodes;
-    auto &adj   = graphWidget->adj;
 
-    // For every pair of edges
-    for (int u = 0; u < adj.size(); u++) {
-        for (int v : adj[u]) {
-            if (u >= v) continue; // avoid duplicates
+    std::vector<std::pair<double,double>> pos;
+    pos.reserve(nodes.size());
+    for (const auto &N : nodes)
+        pos.emplace_back(N.x, N.y);
 
-            QPointF A(nodes[u].x, nodes[u].y);
-            QPointF B(nodes[v].x, nodes[v].y);
-
-            for (int x = u + 1; x < adj.size(); x++) {
-                for (int y : adj[x]) {
-
-                    if (x >= y) continue;
-                    if (u == x || u == y || v == x || v == y)
-                        continue; // share vertex → not a crossing
+    crossingState.reset(pos, graphWidget->adj);
+    return crossingState.totalCrossings();
+}
+void MainWindow::applyLayout(int newK, const std::vector<std::pair<double,double>> &layout)
+{
+    int V = static_cast<int>(graphWidget->nodes.size());
+    if (static_cast<int>(layout.size()) != V)
+        return;   // graph changed since the job was started
 
-                    QPointF C(nodes[x].x, nodes[x].y);
-                    QPointF D(nodes[y].x, nodes[y].y);
+    k = newK;
+    if(k == 0)
+        kLabel->setText("Planar? Yes");
+    else kLabel->setText("Planar? No");
 
-                    if (segmentsIntersect(A, B, C, D))
-                        count++;
-                }
-            }
-        }
-    }
+    animateToLayout(layout);
 
-    return count;
+    statusBar()->clearMessage();
+    autoSave();
 }
-std::vector<std::pair<double,double>> MainWindow::runMultipleLayouts(
-    int V, int E, const std::vector<std::vector<int>>& G)
-{
-    const int RUNS = 3;   // number of random attempts
-    int bestCross = INT_MAX;
-    std::vector<std::pair<double,double>> bestLayout;
-
-    for (int i = 0; i < RUNS; i++)
-    {
-        auto result = Solver::computeLayout(V, E, G, currentHeuristicIndex());
-        auto &layout = result.second;
-
-        // Apply temporary layout to nodes
-        for (int v = 0; v < V; v++) {
-            graphWidget->nodes[v].x = layout[v].first  * 60 + 80;
-            graphWidget->nodes[v].y = layout[v].second * 60 + 80;
-        }
 
-        int c = countCrossings();
+void MainWindow::animateToLayout(const std::vector<std::pair<double,double>> &layout)
+{
+    int V = static_cast<int>(graphWidget->nodes.size());
+    if (static_cast<int>(layout.size()) != V)
+        return;   // graph changed since the job was started
 
-        if (c < bestCross) {
-            bestCross = c;
-            bestLayout = layout;
-        }
-        qDebug() << bestCross;
+    // Build target positions and animate smoothly
+    double scale   = 60.0;
+    double offsetX = 80.0;
+    double offsetY = 80.0;
+    std::vector<QPointF> targets(V);
+    for (int i = 0; i < V; ++i) {
+        double tx = layout[i].first  * scale + offsetX;
+        double ty = layout[i].second * scale + offsetY;
+        targets[i] = QPointF(tx, ty);
     }
-
-    crossLabel->setText("Crossings = " + QString::number(bestCross));
-
-    return bestLayout;
+    graphWidget->animateTo(targets, 450);
 }
 
 
@@ -177,6 +149,24 @@ MainWindow::MainWindow(QWidget *parent)
 
 
 
+        // Layout solves run on a worker thread, results come back here
+        layoutJob = new LayoutJob(this);
+        connect(layoutJob, &LayoutJob::progress, this, [this](int percent) {
+            statusBar()->showMessage("Computing layout... " + QString::number(percent) + "%");
+        });
+        connect(layoutJob, &LayoutJob::finished, this, &MainWindow::applyLayout);
+        connect(layoutJob, &LayoutJob::improved, this, &MainWindow::animateToLayout);
+
+        // Layout cache: files next to the Projects folder, counts in the status bar
+        layoutJob->setCacheDirectory((basePath + "/LayoutCache").toStdString());
+        cacheLabel = new QLabel(this);
+        statusBar()->addPermanentWidget(cacheLabel);
+        connect(layoutJob, &LayoutJob::cacheChecked, this, [this](bool) {
+            LayoutCache::Stats s = layoutJob->cacheStats();
+            cacheLabel->setText(QString("Layout cache: %1 hits (%2 from disk), %3 misses")
+                                    .arg(s.memoryHits + s.diskHits).arg(s.diskHits).arg(s.misses));
+        });
+
         QToolBar *toolbar = addToolBar("Main Toolbar");
         ///toolbar->setMovable(false);   // optional
 
@@ -196,6 +186,11 @@ MainWindow::MainWindow(QWidget *parent)
             "Degree greedy heuristic",
             "Barycentric heuristic",
             "distance refined barycentric heuristic",
+            "2D barycentric heuristic",
+            "distance refined 2D barycentric heuristic",
+            "Multilevel heuristic",
+            "Force-directed (Barnes-Hut) heuristic",
+            "Best heuristic + crossing annealing",
 
         });
         heuristicSelector->setSizeAdjustPolicy(QComboBox::AdjustToContents);
@@ -214,7 +209,7 @@ MainWindow::MainWindow(QWidget *parent)
         // Heuristic chooser to the right of the checkbox
         toolbar->addWidget(heuristicSelector);
 
-        // Initialize and track heuristic index (0..3)
+        // Initialize and track heuristic index (0..Solver::HeuristicCount-1)
         heuristicSelector->setCurrentIndex(0);
         heuristicIndex = 0;
         heuristicSelector->setEnabled(autoUpdateCheck->isChecked());
@@ -226,6 +221,8 @@ MainWindow::MainWindow(QWidget *parent)
                 recomputeLayoutFromGraphState();
             } else {
                 // Do not randomize existing nodes on toggle-off; just mark k unknown and refresh
+                layoutJob->cancel();
+                statusBar()->clearMessage();
                 k = -1;
                 if (kLabel) kLabel->setText("k = ?");
                 crossings = countCrossings();
@@ -237,9 +234,9 @@ MainWindow::MainWindow(QWidget *parent)
 
         connect(heuristicSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
                 this, [this](int idx){
-                    // clamp to 0..3 to be safe if items change
+                    // clamp to the solver's modes to be safe if items change
                     if (idx < 0) idx = 0;
-                    if (idx > 4) idx = 4;
+                    if (idx >= Solver::HeuristicCount) idx = Solver::HeuristicCount - 1;
                     heuristicIndex = idx;
 
                     // Respect auto-update toggle
@@ -368,8 +365,22 @@ MainWindow::MainWindow(QWidget *parent)
         // --------------------------------------------------------
         connect(graphWidget, &GraphWidget::nodeClicked,
                 this, [this](int idx) {
-                    if (idx >= 0 && idx < nodeList->count())
+                    // A shift-click that took the node out of the
+                    // selection leaves the list alone
+                    if (idx >= 0 && idx < nodeList->count() && graphWidget->selectedNode == idx)
                         nodeList->setCurrentRow(idx);
+
+                    // A drag may follow: start it from a fresh crossing state
+                    crossings = countCrossings();
+                });
+
+        connect(graphWidget, &GraphWidget::selectionChanged,
+                this, [this]() {
+                    int count = static_cast<int>(graphWidget->selection.size());
+                    if (count > 0)
+                        statusBar()->showMessage(QString::number(count) + " nodes selected");
+                    else
+                        statusBar()->clearMessage();
                 });
 
         // --------------------------------------------------------
@@ -432,6 +443,9 @@ MainWindow::MainWindow(QWidget *parent)
             }
 
             QJsonArray nodeArr = root["nodes"].toArray();
+            // A new graph: no old id names the same node. setAdjacency
+            // below drops the rest of the selection
+            graphWidget->selectedNode = -1;
             graphWidget->nodes.clear();
             graphWidget->nodes.resize(nodeArr.size());
 
@@ -650,7 +664,7 @@ MainWindow::MainWindow(QWidget *parent)
                         );
                     nodeList->blockSignals(false);
 
-                    graphWidget->update();
+                    graphWidget->nodesChanged(idx);
                     autoSave();
 
                 });
@@ -676,7 +690,7 @@ MainWindow::MainWindow(QWidget *parent)
                         );
                     nodeList->blockSignals(false);
 
-                    graphWidget->update();
+                    graphWidget->nodesChanged(idx);
                     autoSave();
 
                 });
@@ -703,10 +717,10 @@ MainWindow::MainWindow(QWidget *parent)
                     }
 
                     if (maxNode < 0) {
-                        graphWidget->nodes.clear();
-                        graphWidget->adj.clear();
+                        layoutJob->cancel();
+                        graphWidget->setNodes({});
+                        graphWidget->setAdjacency({});
                         nodeList->clear();
-                        graphWidget->update();
                         return;
                     }
 
@@ -775,28 +789,15 @@ MainWindow::MainWindow(QWidget *parent)
                             }
                         }
 
-                        auto layout = Solver::computeLayout(V, E, G, currentHeuristicIndex());
-                        layout.second = runMultipleLayouts(V, E, G);
-
-
-                        k = layout.first;
-                        if(k == 0)
-                            kLabel->setText("Planar? Yes");
-                        else kLabel->setText("Planar? No");
-
-
-                        double scale   = 60.0;
-                        double offsetX = 80.0;
-                        double offsetY = 80.0;
-                        std::vector<QPointF> targets(V);
-                        for (int i = 0; i < V && i < static_cast<int>(layout.second.size()); ++i) {
-                            double tx = layout.second[i].first  * scale + offsetX;
-                            double ty = layout.second[i].second * scale + offsetY;
-                            targets[i] = QPointF(tx, ty);
-                        }
-                        graphWidget->animateTo(targets, 450);
+                        // Solve in the background; applyLayout() animates to the result.
+                        // While editing, "best" streams its incumbents within a fixed latency.
+                        if (currentHeuristicIndex() == Solver::BestHeuristic)
+                            layoutJob->startAnytime(V, E, G, InteractiveLatencyMs);
+                        else
+                            layoutJob->start(V, E, G, currentHeuristicIndex());
                     } else {
                         // Randomize positions only for newly created nodes and reset k
+                        layoutJob->cancel();
                         int Vold = static_cast<int>(old.size());
                         randomizeNodePositionsInRange(Vold, V);
                         k = -1;
@@ -829,9 +830,21 @@ MainWindow::MainWindow(QWidget *parent)
                     autoSave();
                 });
 
-        connect(graphWidget, &GraphWidget::nodeMoved, this, [this]() {
-            // Recalculate crossings live during dragging
-            crossings = countCrossings();
+        connect(graphWidget, &GraphWidget::nodeMoved, this, [this](int idx) {
+            // Recalculate crossings live during dragging: a single dragged node only
+            // re-tests its own edges, animation frames move everything and recount
+            int E = 0;
+            for (const auto &lst : graphWidget->adj) E += static_cast<int>(lst.size());
+            E /= 2;
+
+            if (idx >= 0 && idx < static_cast<int>(graphWidget->nodes.size()) &&
+                crossingState.matches(static_cast<int>(graphWidget->nodes.size()), E)) {
+                const auto &N = graphWidget->nodes[idx];
+                crossingState.moveVertex(idx, N.x, N.y);
+                crossings = crossingState.totalCrossings();
+            } else {
+                crossings = countCrossings();
+            }
             crossLabel->setText("Crossings = " + QString::number(crossings));
         });
 
@@ -875,7 +888,7 @@ void MainWindow::randomizeCurrentNodePositions()
     crossings = countCrossings();
     if (crossLabel) crossLabel->setText("Crossings = " + QString::number(crossings));
 
-    graphWidget->update();
+    graphWidget->nodesChanged();
     autoSave();
 }
 
@@ -896,6 +909,7 @@ void MainWindow::randomizeNodePositionsInRange(int startIdx, int endExclusive)
         graphWidget->nodes[i].x = minX + rx * (maxX - minX);
         graphWidget->nodes[i].y = minY + ry * (maxY - minY);
     }
+    graphWidget->nodesChanged();
 }
 
 void MainWindow::recomputeLayoutFromGraphState()
@@ -912,27 +926,8 @@ void MainWindow::recomputeLayoutFromGraphState()
     for (const auto &lst : G) E += static_cast<int>(lst.size());
     E /= 2;
 
-    auto layout = Solver::computeLayout(V, E, G, currentHeuristicIndex());
-    layout.second = runMultipleLayouts(V, E, G);
-
-    // Update k label
-    k = layout.first;
-    if(k == 0)
-        kLabel->setText("Planar? Yes");
-    else kLabel->setText("Planar? No");
-
-
-    // Build target positions and animate smoothly
-    double scale   = 60.0;
-    double offsetX = 80.0;
-    double offsetY = 80.0;
-    std::vector<QPointF> targets(V);
-    for (int i = 0; i < V && i < static_cast<int>(layout.second.size()); ++i) {
-        double tx = layout.second[i].first  * scale + offsetX;
-        double ty = layout.second[i].second * scale + offsetY;
-        targets[i] = QPointF(tx, ty);
-    }
-    graphWidget->animateTo(targets, 450);
+    // Solve in the background; applyLayout() animates to the result
+    layoutJob->start(V, E, G, currentHeuristicIndex());
 
     // Update crossings label (will also update live via nodeMoved)
     crossings = countCrossings();
@@ -3,11 +3,14 @@
 
 #include <QMainWindow>
 #include "graphwidget.h"
+#include "crossings.h"
 #include <QListWidget>
 #include <QComboBox>
 #include <QLabel>
 #include <QCheckBox>
 
+class LayoutJob;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -24,10 +27,16 @@ public:
     void autoSave();
     int countCrossings();
 
-    // Returns 0..3 depending on the selected heuristic in the dropdown
+    // Solver::Heuristic entry (0..Solver::HeuristicCount-1) selected in the dropdown
     int currentHeuristicIndex() const { return heuristicIndex; }
-    std::vector<std::pair<double,double>> runMultipleLayouts(int V, int E, const std::vector<std::vector<int>> &G);
 private:
+    // Animate to a finished layout (solver coordinates) and refresh k
+    void applyLayout(int newK, const std::vector<std::pair<double,double>> &layout);
+    // Animate to an intermediate layout of an anytime solve
+    void animateToLayout(const std::vector<std::pair<double,double>> &layout);
+
+    // Layout latency while editing the graph with the "best" heuristic
+    static const int InteractiveLatencyMs = 250;
     // Recompute layout and refresh UI using current graphWidget state and heuristic
     void recomputeLayoutFromGraphState();
     // Randomize positions for current nodes and refresh UI (no solver)
@@ -43,10 +52,13 @@ private:
     QLabel *kLabel;
     int k = -1;
     int crossings = 0;
+    CrossingState crossingState;  // kept in sync by countCrossings(), updated per drag step
     QLabel *crossLabel;
+    QLabel *cacheLabel = nullptr; // layout cache hits and misses, in the status bar
     QComboBox *heuristicSelector; // Top-right dropdown for heuristic selection
     QCheckBox *autoUpdateCheck;   // Checkbox to toggle auto layout
+    LayoutJob *layoutJob = nullptr; // background solver, newest request wins
 
-    int heuristicIndex = 0;      // 0..3 maps to the selected heuristic
+    int heuristicIndex = 0;      // Solver::Heuristic of the dropdown entry
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,309 @@
+#include "heuristics.h"
+#include "kdtree.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Multilevel layout: coarsen, lay out the coarsest graph, then
+// project back and refine one level at a time
+//------------------------------------------------------------
+
+namespace {
+
+// Coarsening stops at this size, or when a round removes less than
+// MinShrink of the vertices (nothing left to match)
+const int CoarsestSize = 64;
+const double MinShrink = 0.1;
+const int MaxLevels = 64;
+
+// Local swap sweeps after every projection
+const int SweepsPerLevel = 3;
+
+// One level of the hierarchy as weighted CSR. Level 0 is the input graph;
+// vertex weights count the input vertices merged into a vertex, edge
+// weights the input edges between two of them.
+struct Level {
+    int n = 0;
+    vector<int> offset;           // n + 1 entries
+    vector<int> nbr;
+    vector<double> ew;            // weight of nbr[i]
+    vector<double> vw;
+    vector<int> coarse;           // vertex -> vertex of the next level
+
+    int edgeCount() const { return (int)nbr.size() / 2; }
+};
+
+Level fromCsr(const CsrGraph& g)
+{
+    Level L;
+    L.n = g.vertexCount();
+    L.offset = g.offset;
+    L.nbr = g.nbr;
+    L.ew.assign(g.nbr.size(), 1.0);
+    L.vw.assign(L.n, 1.0);
+    return L;
+}
+
+// Heavy edge matching in random order. The score divides the edge weight by
+// both vertex weights so clusters stay balanced. Unmatched vertices with a
+// single neighbour join that neighbour's cluster, which keeps stars and
+// trees from stalling the coarsening.
+Level coarsen(Level& fine, mt19937& rng)
+{
+    const int n = fine.n;
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+
+    vector<int> match(n, -1);
+    for (int u : order) {
+        if (match[u] != -1) continue;
+        int best = -1;
+        double bestScore = 0;
+        for (int i = fine.offset[u]; i < fine.offset[u + 1]; i++) {
+            int v = fine.nbr[i];
+            if (v == u || match[v] != -1) continue;
+            double score = fine.ew[i] / (fine.vw[u] * fine.vw[v]);
+            if (best < 0 || score > bestScore) {
+                best = v;
+                bestScore = score;
+            }
+        }
+        match[u] = best < 0 ? u : best;
+        if (best >= 0) match[best] = u;
+    }
+
+    auto leafParent = [&](int u) {
+        if (match[u] != u || fine.offset[u + 1] - fine.offset[u] != 1) return -1;
+        int v = fine.nbr[fine.offset[u]];
+        return v == u ? -1 : v;
+    };
+
+    Level coarse;
+    fine.coarse.assign(n, -1);
+    for (int u = 0; u < n; u++) {
+        if (leafParent(u) >= 0 || fine.coarse[u] != -1) continue;
+        fine.coarse[u] = coarse.n;
+        fine.coarse[match[u]] = coarse.n;
+        coarse.n++;
+    }
+    for (int u = 0; u < n; u++) {
+        int v = leafParent(u);
+        if (v >= 0) fine.coarse[u] = fine.coarse[v];
+    }
+
+    // Members of every coarse vertex, by counting sort
+    vector<int> start(coarse.n + 1, 0), members(n);
+    for (int u = 0; u < n; u++) start[fine.coarse[u] + 1]++;
+    for (int c = 0; c < coarse.n; c++) start[c + 1] += start[c];
+    vector<int> fill(start.begin(), start.end() - 1);
+    for (int u = 0; u < n; u++) members[fill[fine.coarse[u]]++] = u;
+
+    // Merge parallel edges; slot[t] is t's position in the current row
+    coarse.vw.assign(coarse.n, 0.0);
+    coarse.offset.assign(coarse.n + 1, 0);
+    vector<int> slot(coarse.n, -1);
+    for (int c = 0; c < coarse.n; c++) {
+        int rowStart = (int)coarse.nbr.size();
+        for (int m = start[c]; m < start[c + 1]; m++) {
+            int u = members[m];
+            coarse.vw[c] += fine.vw[u];
+            for (int i = fine.offset[u]; i < fine.offset[u + 1]; i++) {
+                int t = fine.coarse[fine.nbr[i]];
+                if (t == c) continue;
+                if (slot[t] < 0) {
+                    slot[t] = (int)coarse.nbr.size();
+                    coarse.nbr.push_back(t);
+                    coarse.ew.push_back(0.0);
+                }
+                coarse.ew[slot[t]] += fine.ew[i];
+            }
+        }
+        for (int i = rowStart; i < (int)coarse.nbr.size(); i++) slot[coarse.nbr[i]] = -1;
+        coarse.offset[c + 1] = (int)coarse.nbr.size();
+    }
+    return coarse;
+}
+
+// Regular s x s grid (row-major) stretched over the final r x r grid, so
+// positions carry over between levels unchanged
+vector<pair<double,double>> level_cells(int s, int r)
+{
+    double step = s > 1 ? (double)(r - 1) / (s - 1) : 0.0;
+    vector<pair<double,double>> cells;
+    cells.reserve((size_t)s * s);
+    for (int i = 0; i < s; i++)
+        for (int j = 0; j < s; j++)
+            cells.emplace_back(j * step, i * step);
+    return cells;
+}
+
+double dist(const pair<double,double>& a, const pair<double,double>& b)
+{
+    return hypot(a.first - b.first, a.second - b.second);
+}
+
+// Every vertex goes to the free cell nearest to its wanted position;
+// heavier vertices choose first
+vector<int> snap_to_cells(const Level& L, const vector<pair<double,double>>& wanted,
+                          const vector<pair<double,double>>& cells)
+{
+    vector<int> order(L.n);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return L.vw[a] > L.vw[b]; });
+
+    KdTree free_cells(cells);
+    vector<int> cell(L.n, -1);
+    for (int v : order) {
+        cell[v] = free_cells.nearest(wanted[v].first, wanted[v].second);
+        free_cells.remove(cell[v]);
+    }
+    return cell;
+}
+
+// Sweeps over all vertices; each one moves to the neighbouring cell (or
+// swaps with its occupant) that shortens its weighted edges the most.
+// One sweep costs O(n + m).
+void sweep_refine(const Level& L, vector<int>& cell,
+                  const vector<pair<double,double>>& cells, int s,
+                  int sweeps, const SolverControl& control)
+{
+    vector<int> occupant(cells.size(), -1);
+    for (int v = 0; v < L.n; v++) occupant[cell[v]] = v;
+
+    // Change of x's weighted edge length when it moves from p_from to
+    // p_to, ignoring edges to 'other' (they keep their length in a swap)
+    auto move_gain = [&](int x, int other, int p_from, int p_to) {
+        double gain = 0.0;
+        for (int i = L.offset[x]; i < L.offset[x + 1]; i++) {
+            int y = L.nbr[i];
+            if (y == other) continue;
+            gain += L.ew[i] * (dist(cells[p_from], cells[cell[y]]) - dist(cells[p_to], cells[cell[y]]));
+        }
+        return gain;
+    };
+
+    for (int pass = 0; pass < sweeps; pass++) {
+        if (control.cancelled()) return;
+        bool moved = false;
+
+        for (int u = 0; u < L.n; u++) {
+            int from = cell[u];
+            int fx = from % s, fy = from / s;
+            int bestTo = -1;
+            double bestGain = 1e-9;
+
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int x = fx + dx, y = fy + dy;
+                    if ((dx == 0 && dy == 0) || x < 0 || y < 0 || x >= s || y >= s) continue;
+                    int to = y * s + x;
+                    int w = occupant[to];
+                    double gain = move_gain(u, w, from, to);
+                    if (w >= 0) gain += move_gain(w, u, to, from);
+                    if (gain > bestGain) {
+                        bestGain = gain;
+                        bestTo = to;
+                    }
+                }
+            }
+
+            if (bestTo < 0) continue;
+            int w = occupant[bestTo];
+            cell[u] = bestTo;
+            occupant[bestTo] = u;
+            occupant[from] = w;
+            if (w >= 0) cell[w] = from;
+            moved = true;
+        }
+        if (!moved) return;
+    }
+}
+
+} // namespace
+
+vector<int> multilevel_assignment(
+    int V,
+    const CsrGraph& g,
+    const vector<pair<double,double>>& coords,
+    int r,
+    unsigned seed,
+    const SolverControl& control)
+{
+    if (V <= 0) return {};
+
+    // Cancelled half way: any valid layout on the final grid will do
+    vector<int> trivial(V);
+    iota(trivial.begin(), trivial.end(), 0);
+
+    mt19937 rng(seed);
+
+    // Coarsening
+    vector<Level> levels;
+    levels.push_back(fromCsr(g));
+    while (levels.back().n > CoarsestSize && (int)levels.size() < MaxLevels) {
+        if (control.cancelled()) break;
+        Level next = coarsen(levels.back(), rng);
+        if (next.n > (1.0 - MinShrink) * levels.back().n) break;
+        levels.push_back(std::move(next));
+    }
+    if (control.cancelled()) return trivial;
+    const int top = (int)levels.size() - 1;
+
+    // Cells of every level; level 0 uses the real candidate grid
+    vector<vector<pair<double,double>>> cells(levels.size());
+    vector<int> side(levels.size());
+    cells[0] = coords;
+    side[0] = r;
+    for (int l = 1; l <= top; l++) {
+        side[l] = grid_side(levels[l].n);
+        cells[l] = level_cells(side[l], r);
+    }
+
+    // Coarsest graph: the flat heuristics on a unit grid of the same shape
+    const Level& coarsest = levels[top];
+    vector<vector<int>> coarseAdj(coarsest.n);
+    for (int v = 0; v < coarsest.n; v++)
+        coarseAdj[v].assign(coarsest.nbr.begin() + coarsest.offset[v],
+                            coarsest.nbr.begin() + coarsest.offset[v + 1]);
+    const CsrGraph coarseGraph(coarseAdj, coarsest.n);
+
+    const vector<pair<double,double>> unitCells =
+        top == 0 ? coords : perturbed_grid(side[top], seed);
+    vector<int> cell = barycentric_2d_assignment(coarsest.n, coarseGraph, unitCells, spiralOrder(side[top]), control);
+    cell = distance_refinement_assignment(coarsest.n, coarseGraph, cell, unitCells,
+                                          target_distance(coarsest.n, coarsest.edgeCount()),
+                                          side[top], seed, control);
+    sweep_refine(coarsest, cell, cells[top], side[top], SweepsPerLevel, control);
+
+    // Projection: a vertex wants the middle between its cluster and the
+    // clusters of its neighbours, then takes the nearest free cell
+    for (int l = top - 1; l >= 0; l--) {
+        if (control.cancelled()) break;
+        const Level& L = levels[l];
+        const vector<pair<double,double>>& parentCells = cells[l + 1];
+        auto parentPos = [&](int v) { return parentCells[cell[L.coarse[v]]]; };
+
+        vector<pair<double,double>> wanted(L.n);
+        for (int v = 0; v < L.n; v++) {
+            pair<double,double> p = parentPos(v);
+            double mx = 0, my = 0, total = 0;
+            for (int i = L.offset[v]; i < L.offset[v + 1]; i++) {
+                pair<double,double> q = parentPos(L.nbr[i]);
+                mx += L.ew[i] * q.first;
+                my += L.ew[i] * q.second;
+                total += L.ew[i];
+            }
+            wanted[v] = total > 0 ? make_pair(0.5 * (p.first + mx / total), 0.5 * (p.second + my / total)) : p;
+        }
+
+        cell = snap_to_cells(L, wanted, cells[l]);
+        sweep_refine(L, cell, cells[l], side[l], SweepsPerLevel, control);
+    }
+
+    return (int)cell.size() == V ? cell : trivial;
+}
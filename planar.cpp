@@ -0,0 +1,90 @@
+#include "heuristics.h"
+#include <algorithm>
+#include <iterator>
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/boyer_myrvold_planar_test.hpp>
+#include <boost/graph/make_connected.hpp>
+#include <boost/graph/make_biconnected_planar.hpp>
+#include <boost/graph/make_maximal_planar.hpp>
+#include <boost/graph/planar_canonical_ordering.hpp>
+#include <boost/graph/chrobak_payne_drawing.hpp>
+
+using namespace std;
+using namespace boost;
+
+//------------------------------------------------------------
+// Planar straight-line drawing: embed, triangulate, canonical
+// ordering, then Chrobak-Payne on the (2V-4) x (V-2) grid
+//------------------------------------------------------------
+
+namespace {
+
+using PlanarGraph = adjacency_list<vecS, vecS, undirectedS,
+                                   property<vertex_index_t, int>,
+                                   property<edge_index_t, int>>;
+using PlanarEdge = graph_traits<PlanarGraph>::edge_descriptor;
+using Embedding = vector<vector<PlanarEdge>>;
+
+// Every step that adds edges invalidates the edge indices and the
+// embedding, so both are rebuilt after it (the test is by far the most
+// expensive part, so a step that added nothing is not followed by one)
+bool embed(PlanarGraph& g, Embedding& embedding)
+{
+    int index = 0;
+    graph_traits<PlanarGraph>::edge_iterator ei, ei_end;
+    for (tie(ei, ei_end) = edges(g); ei != ei_end; ++ei)
+        put(edge_index, g, *ei, index++);
+
+    embedding.assign(num_vertices(g), {});
+    return boyer_myrvold_planarity_test(boyer_myrvold_params::graph = g,
+                                        boyer_myrvold_params::embedding = &embedding[0]);
+}
+
+struct GridPoint {
+    size_t x, y;
+};
+
+} // namespace
+
+vector<pair<double,double>> planar_straight_line_drawing(const CsrGraph& graph)
+{
+    const int V = graph.vertexCount();
+    if (V == 0) return {};
+    if (V == 1) return {{0.0, 0.0}};
+    if (V == 2) return {{0.0, 0.0}, {1.0, 0.0}};
+
+    // Chrobak-Payne wants a simple graph: parallel edges go
+    vector<pair<int,int>> simple = graph.edges;
+    sort(simple.begin(), simple.end());
+    simple.erase(unique(simple.begin(), simple.end()), simple.end());
+    PlanarGraph g(simple.begin(), simple.end(), V);
+
+    Embedding embedding;
+    if (!embed(g, embedding)) return {};
+
+    auto edgesBefore = num_edges(g);
+    make_connected(g);
+    if (num_edges(g) != edgesBefore) embed(g, embedding);
+
+    edgesBefore = num_edges(g);
+    make_biconnected_planar(g, &embedding[0]);
+    if (num_edges(g) != edgesBefore) embed(g, embedding);
+
+    edgesBefore = num_edges(g);
+    make_maximal_planar(g, &embedding[0]);
+    if (num_edges(g) != edgesBefore) embed(g, embedding);
+
+    vector<graph_traits<PlanarGraph>::vertex_descriptor> ordering;
+    planar_canonical_ordering(g, &embedding[0], back_inserter(ordering));
+
+    vector<GridPoint> points(V);
+    chrobak_payne_straight_line_drawing(
+        g, make_iterator_property_map(embedding.begin(), get(vertex_index, g)),
+        ordering.begin(), ordering.end(),
+        make_iterator_property_map(points.begin(), get(vertex_index, g)));
+
+    vector<pair<double,double>> drawing(V);
+    for (int v = 0; v < V; v++)
+        drawing[v] = {(double)points[v].x, (double)points[v].y};
+    return drawing;
+}
@@ -0,0 +1,108 @@
+#include "sceneindex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void SceneIndex::build(const vector<pair<double,double>>& positions,
+                       const vector<vector<int>>& adj)
+{
+    const int n = (int)positions.size();
+    edgeIndex.build(positions, CrossingCounter::edgeList(adj, min(n, (int)adj.size())));
+
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int v = 0; v < n; v++) {
+        if (v == 0 || positions[v].first < minX)  minX = positions[v].first;
+        if (v == 0 || positions[v].first > maxX)  maxX = positions[v].first;
+        if (v == 0 || positions[v].second < minY) minY = positions[v].second;
+        if (v == 0 || positions[v].second > maxY) maxY = positions[v].second;
+    }
+    double W = maxX - minX, H = maxY - minY;
+
+    // About two nodes per cell
+    cell = sqrt(2.0 * W * H / max(1, n));
+    if (!(cell > 0)) cell = max(1.0, max(W, H));
+    while ((W / cell + 1) * (H / cell + 1) > 4.0 * n + 64)
+        cell *= 1.5;
+
+    originX = minX;
+    originY = minY;
+    gridW = (int)(W / cell) + 1;
+    gridH = (int)(H / cell) + 1;
+
+    cells.assign((size_t)gridW * gridH, {});
+    nodeCell.resize(n);
+    for (int v = 0; v < n; v++) {
+        nodeCell[v] = cellOf(positions[v].first, positions[v].second);
+        cells[nodeCell[v]].push_back(v);
+    }
+}
+
+int SceneIndex::cellX(double x) const
+{
+    double c = floor((x - originX) / cell);
+    if (!(c > 0)) return 0;
+    return c >= gridW - 1 ? gridW - 1 : (int)c;
+}
+
+int SceneIndex::cellY(double y) const
+{
+    double c = floor((y - originY) / cell);
+    if (!(c > 0)) return 0;
+    return c >= gridH - 1 ? gridH - 1 : (int)c;
+}
+
+void SceneIndex::moveNode(int v, double x, double y)
+{
+    if (v < 0 || v >= nodeCount()) return;
+
+    edgeIndex.moveVertex(v, x, y);
+
+    int to = cellOf(x, y);
+    if (to == nodeCell[v]) return;
+    vector<int>& from = cells[nodeCell[v]];
+    auto it = find(from.begin(), from.end(), v);
+    if (it != from.end()) {
+        *it = from.back();
+        from.pop_back();
+    }
+    cells[to].push_back(v);
+    nodeCell[v] = to;
+}
+
+void SceneIndex::nodesInBox(double x0, double y0, double x1, double y1, vector<int>& out) const
+{
+    const auto& pos = positions();
+    int cx0 = cellX(x0), cx1 = cellX(x1), cy0 = cellY(y0), cy1 = cellY(y1);
+    for (int cy = cy0; cy <= cy1; cy++)
+        for (int cx = cx0; cx <= cx1; cx++)
+            for (int v : cells[(size_t)cy * gridW + cx]) {
+                const auto& p = pos[v];
+                if (p.first >= x0 && p.first <= x1 && p.second >= y0 && p.second <= y1)
+                    out.push_back(v);
+            }
+}
+
+int SceneIndex::nearestNode(double x, double y, double maxDist) const
+{
+    if (!(maxDist >= 0)) return -1;
+
+    const auto& pos = positions();
+    const double limit = maxDist * maxDist;
+    int best = -1;
+    double bestD2 = 0;
+    int cx0 = cellX(x - maxDist), cx1 = cellX(x + maxDist);
+    int cy0 = cellY(y - maxDist), cy1 = cellY(y + maxDist);
+    for (int cy = cy0; cy <= cy1; cy++)
+        for (int cx = cx0; cx <= cx1; cx++)
+            for (int v : cells[(size_t)cy * gridW + cx]) {
+                double dx = pos[v].first - x, dy = pos[v].second - y;
+                double d2 = dx * dx + dy * dy;
+                if (d2 > limit) continue;
+                if (best < 0 || d2 < bestD2 || (d2 == bestD2 && v < best)) {
+                    best = v;
+                    bestD2 = d2;
+                }
+            }
+    return best;
+}
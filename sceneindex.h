@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "crossings.h"
+
+// Spatial index of a drawing for the UI: nodes bucketed on a uniform grid,
+// edges by bounding box in an EdgeIndex. Viewport queries cost about what
+// they return; moving a node costs O(its degree). Like EdgeIndex, points
+// that leave the grid built by build() are clamped into the border cells.
+class SceneIndex {
+public:
+    void build(const std::vector<std::pair<double, double>>& positions,
+               const std::vector<std::vector<int>>& adj);
+
+    void moveNode(int v, double x, double y);
+
+    int nodeCount() const { return (int)nodeCell.size(); }
+    const std::vector<std::pair<double, double>>& positions() const { return edgeIndex.positions(); }
+    const std::vector<std::pair<int, int>>& edgeList() const { return edgeIndex.edgeList(); }
+
+    // Nodes inside [x0, x1] x [y0, y1], appended to out in no particular order
+    void nodesInBox(double x0, double y0, double x1, double y1, std::vector<int>& out) const;
+
+    // Nearest node within maxDist of (x, y), ties to the smaller id, or -1.
+    // Looks only at the cells the circle's box covers
+    int nearestNode(double x, double y, double maxDist) const;
+
+    // Edges whose bounding box meets [x0, x1] x [y0, y1], each once
+    void edgesInBox(double x0, double y0, double x1, double y1, std::vector<int>& out) const
+    {
+        edgeIndex.edgesInBox(x0, y0, x1, y1, out);
+    }
+
+private:
+    int cellX(double x) const;
+    int cellY(double y) const;
+    int cellOf(double x, double y) const { return cellY(y) * gridW + cellX(x); }
+
+    double originX = 0, originY = 0, cell = 1;
+    int gridW = 1, gridH = 1;
+    std::vector<std::vector<int>> cells;   // row-major, node ids
+    std::vector<int> nodeCell;             // node -> cell
+
+    EdgeIndex edgeIndex;
+};
@@ -0,0 +1,296 @@
+#include "crossings.h"
+#include "freeslots.h"
+#include "kdtree.h"
+#include "sceneindex.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+//------------------------------------------------------------
+// Self-check: the crossing counters and the spatial indexes against
+// plain reference scans, on seeded random and degenerate inputs
+// (collinear, touching, coincident points). Registered with ctest;
+// exits non-zero if any answer differs.
+//------------------------------------------------------------
+
+namespace {
+
+using Points = vector<pair<double,double>>;
+using Graph = vector<vector<int>>;
+
+int failures = 0;
+
+void expect(bool ok, const string& what)
+{
+    if (ok) return;
+    if (++failures <= 20) fprintf(stderr, "FAIL %s\n", what.c_str());
+}
+
+// mt19937 output is fixed by the standard, unlike the distributions, so
+// a failing case is the same under every standard library
+int below(mt19937& rng, int n) { return (int)(rng() % (uint32_t)n); }
+double unit(mt19937& rng) { return rng() / 4294967296.0; }
+
+// Coordinates of one of three kinds: reals, small integers (many
+// collinear triples, shared lines and coincident points), or all on
+// one line
+enum Kind { RealPoints, IntegerPoints, LinePoints, KindCount };
+
+const char* kindName(int kind)
+{
+    static const char* names[] = {"real", "integer", "line"};
+    return names[kind];
+}
+
+pair<double,double> randomPoint(mt19937& rng, int kind, double spread = 1)
+{
+    switch (kind) {
+    case IntegerPoints: return {(double)below(rng, 5) * spread, (double)below(rng, 5) * spread};
+    case LinePoints: { double t = below(rng, 8) * spread; return {t, 2 * t}; }
+    default: return {unit(rng) * spread, unit(rng) * spread};
+    }
+}
+
+Graph randomGraph(mt19937& rng, int V, int E)
+{
+    Graph adj(V);
+    for (int e = 0; e < E && V > 1; e++) {
+        int u = below(rng, V);
+        int v = below(rng, V);
+        if (u == v) continue;
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+    }
+    return adj;
+}
+
+//------------------------------------------------------------
+// Crossings: count(), EdgeIndex and CrossingState against countBruteForce()
+//------------------------------------------------------------
+
+void checkDrawing(const Points& pos, const Graph& adj, const string& name)
+{
+    vector<int> expected, got;
+    const int total = CrossingCounter::countBruteForce(pos, adj, &expected);
+
+    expect(CrossingCounter::count(pos, adj, &got) == total && got == expected, name + ": count");
+    expect(CrossingCounter::count(pos, adj) == total, name + ": count without perEdge");
+
+    for (double cellSize : {0.0, 0.3, 5.0}) {
+        EdgeIndex index;
+        index.build(pos, adj, cellSize);
+        expect(index.countCrossings(&got) == total && got == expected,
+               name + ": EdgeIndex cell " + to_string(cellSize));
+    }
+}
+
+// Moves vertices one at a time, some far outside the first drawing, and
+// compares the incremental counts after every move
+void checkMoves(mt19937& rng, Points pos, const Graph& adj, int kind, const string& name)
+{
+    const int V = (int)pos.size();
+    CrossingState state;
+    state.reset(pos, adj);
+    EdgeIndex index;
+    index.build(pos, adj);
+
+    for (int step = 0; step < 40 && V > 0; step++) {
+        const int v = below(rng, V);
+        pos[v] = below(rng, 4) == 0 ? randomPoint(rng, kind, 3) : randomPoint(rng, kind);
+        state.moveVertex(v, pos[v].first, pos[v].second);
+        index.moveVertex(v, pos[v].first, pos[v].second);
+
+        vector<int> expected, got;
+        const int total = CrossingCounter::countBruteForce(pos, adj, &expected);
+        const string at = name + " move " + to_string(step);
+        expect(state.totalCrossings() == total && state.edgeCrossings() == expected,
+               at + ": CrossingState");
+        expect(index.countCrossings(&got) == total && got == expected, at + ": EdgeIndex");
+    }
+}
+
+void checkCrossings()
+{
+    // Hand-made degenerate pairs: proper cross, T touch, endpoint on an
+    // edge, collinear overlap, collinear disjoint, shared endpoint,
+    // coincident vertices, vertical and horizontal edges
+    const vector<pair<string, Points>> cases = {
+        {"cross",       {{0, 0}, {2, 2}, {0, 2}, {2, 0}}},
+        {"T touch",     {{0, 0}, {2, 0}, {1, 0}, {1, 1}}},
+        {"end on edge", {{0, 0}, {2, 2}, {1, 1}, {3, 0}}},
+        {"overlap",     {{0, 0}, {2, 0}, {1, 0}, {3, 0}}},
+        {"contained",   {{0, 0}, {3, 3}, {1, 1}, {2, 2}}},
+        {"collinear",   {{0, 0}, {1, 0}, {2, 0}, {3, 0}}},
+        {"coincident",  {{0, 0}, {2, 2}, {0, 0}, {2, 2}}},
+        {"same start",  {{0, 0}, {2, 0}, {0, 0}, {0, 2}}},
+        {"axes",        {{1, 0}, {1, 2}, {0, 1}, {2, 1}}},
+    };
+    const Graph pair2 = {{1}, {0}, {3}, {2}};
+    for (const auto& c : cases) checkDrawing(c.second, pair2, c.first);
+
+    // Two edges sharing an endpoint never cross, even when collinear
+    checkDrawing({{0, 0}, {2, 0}, {1, 0}}, {{1, 2}, {0}, {0}}, "shared endpoint");
+
+    mt19937 rng(20240611u);
+    for (int kind = 0; kind < KindCount; kind++)
+        for (int round = 0; round < 60; round++) {
+            const int V = 2 + below(rng, 30);
+            const int E = below(rng, 3 * V);
+            Points pos(V);
+            for (auto& p : pos) p = randomPoint(rng, kind);
+            const Graph adj = randomGraph(rng, V, E);
+
+            const string name = string(kindName(kind)) + " #" + to_string(round);
+            checkDrawing(pos, adj, name);
+            if (round % 4 == 0) checkMoves(rng, pos, adj, kind, name);
+        }
+}
+
+//------------------------------------------------------------
+// Nearest queries: KdTree and SceneIndex against a scan
+//------------------------------------------------------------
+
+// Closest point within maxDist, lowest index on ties, -1 if none
+int nearestScan(const Points& pts, const vector<char>& present, double x, double y, double maxDist)
+{
+    int best = -1;
+    double bestD2 = maxDist * maxDist;
+    for (int i = 0; i < (int)pts.size(); i++) {
+        if (!present[i]) continue;
+        double dx = pts[i].first - x, dy = pts[i].second - y;
+        double d2 = dx * dx + dy * dy;
+        if (d2 < bestD2 || (d2 == bestD2 && best < 0)) {
+            best = i;
+            bestD2 = d2;
+        }
+    }
+    return best;
+}
+
+double randomRadius(mt19937& rng)
+{
+    switch (below(rng, 4)) {
+    case 0:  return numeric_limits<double>::infinity();
+    case 1:  return 1.0;        // integer points sit exactly this far apart
+    default: return 2 * unit(rng);
+    }
+}
+
+void checkKdTree()
+{
+    mt19937 rng(7001u);
+    for (int kind = 0; kind < KindCount; kind++)
+        for (int round = 0; round < 40; round++) {
+            const int n = 1 + below(rng, 60);
+            Points pts(n);
+            for (auto& p : pts) p = randomPoint(rng, kind);
+            KdTree tree(pts);
+            vector<char> present(n, 1);
+
+            const string name = string("KdTree ") + kindName(kind) + " #" + to_string(round);
+            for (int step = 0; step <= n; step++) {
+                for (int q = 0; q < 8; q++) {
+                    auto at = randomPoint(rng, kind);
+                    if (q % 2) at = {at.first + unit(rng) - 0.5, at.second + unit(rng) - 0.5};
+                    const double r = randomRadius(rng);
+                    expect(tree.nearest(at.first, at.second, r) ==
+                           nearestScan(pts, present, at.first, at.second, r), name);
+                }
+                if (step == n) break;
+                int i = below(rng, n);
+                tree.remove(i);
+                present[i] = 0;
+                expect(!tree.contains(i), name + ": remove");
+            }
+        }
+}
+
+void checkSceneIndex()
+{
+    mt19937 rng(7002u);
+    for (int kind = 0; kind < KindCount; kind++)
+        for (int round = 0; round < 40; round++) {
+            const int n = 1 + below(rng, 80);
+            Points pts(n);
+            for (auto& p : pts) p = randomPoint(rng, kind);
+            SceneIndex index;
+            index.build(pts, randomGraph(rng, n, n));
+            const vector<char> present(n, 1);
+
+            const string name = string("SceneIndex ") + kindName(kind) + " #" + to_string(round);
+            for (int step = 0; step < 20; step++) {
+                for (int q = 0; q < 8; q++) {
+                    auto at = randomPoint(rng, kind, 1.5);
+                    const double r = 2 * unit(rng);
+                    expect(index.nearestNode(at.first, at.second, r) ==
+                           nearestScan(index.positions(), present, at.first, at.second, r), name);
+                }
+                // Some moves leave the grid built for the first drawing
+                int v = below(rng, n);
+                auto to = randomPoint(rng, kind, below(rng, 3) == 0 ? 4 : 1);
+                index.moveNode(v, to.first, to.second);
+            }
+        }
+}
+
+//------------------------------------------------------------
+// FreeSlots against an ordered set
+//------------------------------------------------------------
+
+void checkFreeSlots()
+{
+    mt19937 rng(7003u);
+    for (int round = 0; round < 60; round++) {
+        const int n = below(rng, 100);
+        FreeSlots slots(n);
+        set<int> free;
+        for (int s = 0; s < n; s++) free.insert(s);
+
+        const string name = "FreeSlots #" + to_string(round);
+        while (true) {
+            expect(slots.freeCount() == (int)free.size(), name + ": freeCount");
+            for (int s = -2; s <= n + 1; s++) {
+                auto above = free.lower_bound(s);
+                auto upto = free.upper_bound(s);
+                int successor = above == free.end() ? -1 : *above;
+                int predecessor = upto == free.begin() ? -1 : *prev(upto);
+                expect(slots.isFree(s) == (free.count(s) > 0), name + ": isFree");
+                expect(slots.successor(s) == successor, name + ": successor");
+                expect(slots.predecessor(s) == predecessor, name + ": predecessor");
+            }
+            if (free.empty()) break;
+
+            // Take a random free slot, sometimes a whole run of them
+            int s = *next(free.begin(), below(rng, (int)free.size()));
+            for (int k = below(rng, 3) == 0 ? 4 : 1; k > 0 && free.count(s); k--, s++) {
+                slots.take(s);
+                free.erase(s);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    checkCrossings();
+    checkKdTree();
+    checkSceneIndex();
+    checkFreeSlots();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
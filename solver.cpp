@@ -1,4 +1,11 @@
 #include "solver.h"
+#include "crossings.h"
+#include "threadpool.h"
+#include "csrgraph.h"
+#include "heuristics.h"
+#include "freeslots.h"
+#include "kdtree.h"
+#include "components.h"
 #include <vector>
 #include <cmath>
 #include <random>
@@ -6,7 +13,15 @@
 #include <fstream>
 #include <algorithm>
 #include <limits>
-#include <QDebug>
+#include <future>
+#include <memory>
+#include <chrono>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <iostream>
+#include <sstream>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/boyer_myrvold_planar_test.hpp>
 
@@ -18,48 +33,75 @@ using namespace boost;
 #define M_PI 3.14159265358979323846
 #endif
 
-static bool segmentsIntersectSolver(
-    double Ax, double Ay, double Bx, double By,
-    double Cx, double Cy, double Dx, double Dy)
+// Diagnostics go to stderr as whole lines, so concurrent runs do not interleave
+static atomic<bool> verboseLog(true);
+
+template <class... Parts>
+static void trace(const Parts&... parts)
 {
-    auto ccw = [](double Ax, double Ay, double Bx, double By, double Cx, double Cy){
-        return (Cy - Ay) * (Bx - Ax) > (By - Ay) * (Cx - Ax);
-    };
+    if (!verboseLog.load(memory_order_relaxed)) return;
+    ostringstream line;
+    (line << ... << parts) << "\n";
+    cerr << line.str();
+}
+
+void Solver::setVerbose(bool on)
+{
+    verboseLog = on;
+}
 
-    return ccw(Ax,Ay,Cx,Cy,Dx,Dy) != ccw(Bx,By,Cx,Cy,Dx,Dy) &&
-           ccw(Ax,Ay,Bx,By,Cx,Cy) != ccw(Ax,Ay,Bx,By,Dx,Dy);
+const char* Solver::heuristicName(int heuristicIndex)
+{
+    static const char* const names[HeuristicCount] = {
+        "best", "spiral", "degree", "barycentric", "refined",
+        "barycentric2d", "refined2d", "multilevel",
+        "force", "annealing"
+    };
+    if (heuristicIndex < 0 || heuristicIndex >= HeuristicCount) return "";
+    return names[heuristicIndex];
 }
 
+// Solver layouts live on a bounded grid with mostly short edges, where the
+// cell index beats the sweep (which degrades to pair scans on many crossings)
 static int countCrossingsSolver(
     const vector<pair<double,double>>& pos,
-    const vector<vector<int>>& adj)
+    const CsrGraph& g,
+    const function<bool()>& stop = nullptr)
 {
-    int count = 0;
-    int n = adj.size();
-
-    for (int u = 0; u < n; u++) {
-        for (int v : adj[u]) {
-            if (u >= v) continue;
-
-            double Ax = pos[u].first,  Ay = pos[u].second;
-            double Bx = pos[v].first,  By = pos[v].second;
-
-            for (int x = u + 1; x < n; x++) {
-                for (int y : adj[x]) {
-                    if (x >= y) continue;
-                    if (u == x || u == y || v == x || v == y) continue;
+    EdgeIndex index;
+    index.build(pos, g.edges);
+    return index.countCrossings(nullptr, stop);
+}
 
-                    double Cx = pos[x].first,  Cy = pos[x].second;
-                    double Dx = pos[y].first,  Dy = pos[y].second;
+// Moves a planar straight-line drawing to the origin and scales it so
+// that the closest two nodes are one grid unit apart, the spacing of a grid
+// layout. Squeezing the (2V-4) x (V-2) Chrobak-Payne grid into the r x r
+// area of a grid layout instead stacks nodes on top of each other from
+// about V = 100 on. The map is a uniform scale, so no crossing appears.
+static vector<pair<double,double>> spaceDrawing(vector<pair<double,double>> drawing)
+{
+    if (drawing.empty()) return drawing;
+    double x0 = drawing[0].first, y0 = drawing[0].second;
+    for (const auto& p : drawing) {
+        x0 = min(x0, p.first);
+        y0 = min(y0, p.second);
+    }
 
-                    if (segmentsIntersectSolver(Ax,Ay,Bx,By, Cx,Cy,Dx,Dy))
-                        count++;
-                }
-            }
-        }
+    // Closest pair: each point against the ones after it
+    double closest = numeric_limits<double>::infinity();
+    KdTree tree(drawing);
+    for (int i = 0; i + 1 < (int)drawing.size(); i++) {
+        tree.remove(i);
+        int j = tree.nearest(drawing[i].first, drawing[i].second);
+        if (j >= 0)
+            closest = min(closest, hypot(drawing[j].first - drawing[i].first,
+                                         drawing[j].second - drawing[i].second));
     }
+    double scale = closest > 0 && closest < numeric_limits<double>::infinity() ? 1.0 / closest : 1.0;
 
-    return count;
+    for (auto& p : drawing)
+        p = {(p.first - x0) * scale, (p.second - y0) * scale};
+    return drawing;
 }
 
 
@@ -67,19 +109,10 @@ static int countCrossingsSolver(
 // Type aliases for Boost graph
 using BoostGraph = adjacency_list<vecS, vecS, undirectedS>;
 
-// Our wrapper: takes your adj and returns true if planar
-bool isPlanar(const vector<vector<int>>& adj) {
-    int n = (int)adj.size();
-    BoostGraph g(n);
-
-    // Add edges (avoid duplicates: only add u<v)
-    for (int u = 0; u < n; ++u) {
-        for (int v : adj[u]) {
-            if (u < v) {
-                add_edge(u, v, g);
-            }
-        }
-    }
+// Our wrapper: takes the CSR graph and returns true if planar
+bool isPlanar(const CsrGraph& graph) {
+    // Built in one go from the flat edge array (each edge once, u<v)
+    BoostGraph g(graph.edges.begin(), graph.edges.end(), graph.vertexCount());
 
     // BoyerâMyrvold planarity test (linear time, fully vetted)
     return boyer_myrvold_planarity_test(g);
@@ -135,47 +168,90 @@ vector<int> spiralOrder(int r) {
     return ord;
 }
 
+//------------------------------------------------------------
+// Candidate positions: an r x r grid, every point jittered by up to 2
+//------------------------------------------------------------
+int grid_side(int V) {
+    return (int)((long long)ceil(sqrt((double)V)) * 4 / 3 + 1);
+}
+
+vector<pair<double,double>> perturbed_grid(int r, unsigned seed) {
+    double perturb = 2;
+
+    mt19937 rng(seed);
+    uniform_real_distribution<double> d(-perturb, perturb);
+
+    vector<pair<double,double>> coords;
+    coords.reserve((size_t)r * r);
+
+    for (long long i = 0; i < r; i++) {
+        for (long long j = 0; j < r; j++) {
+            double x = (double)j + d(rng);
+            double y = (double)i + d(rng);
+            coords.emplace_back(x, y);
+        }
+    }
+    return coords;
+}
+
+// Edge length the refinement aims for
+double target_distance(int V, int E) {
+    return sqrt((2.0 * E) / (M_PI * V));
+}
+
 //------------------------------------------------------------
 // Greedy barycentric assignment
 //------------------------------------------------------------
 vector<int> barycentric_assignment(
     int V,
-    const vector<vector<int>>& adj,
+    const CsrGraph& g,
     const vector<int>& position_order)
 {
     vector<int> assignment(V, -1);       // vertex -> grid index
-    vector<bool> used(position_order.size(), false);
 
+    // Free grid indices by value (nearest to the barycenter) and the order
+    // rank of each index (ties go to the earlier one in position_order)
+    int slots = 0;
+    for (int idx : position_order) slots = max(slots, idx + 1);
+    FreeSlots free_idx(slots);
+    vector<int> rank(slots, -1);
+    for (int i = 0; i < (int)position_order.size(); i++)
+        if (rank[position_order[i]] < 0) rank[position_order[i]] = i;
+    for (int idx = 0; idx < slots; idx++)
+        if (rank[idx] < 0) free_idx.take(idx);
+
+    // Slots are never freed again, so the first free one only moves forward
+    size_t cursor = 0;
     auto next_free = [&]() -> int {
-        for (int idx : position_order)
-            if (!used[idx]) return idx;
-        return -1;
+        while (cursor < position_order.size() && !free_idx.isFree(position_order[cursor]))
+            cursor++;
+        return cursor < position_order.size() ? position_order[cursor] : -1;
     };
 
     for (int v = 0; v < V; v++) {
-        // find placed neighbors
-        vector<int> placed;
-        for (int u : adj[v])
-            if (assignment[u] != -1)
-                placed.push_back(u);
+        // barycenter of placed neighbors
+        double avg = 0;
+        int placed = 0;
+        for (int u : g.neighbours(v))
+            if (assignment[u] != -1) {
+                avg += assignment[u];
+                placed++;
+            }
 
         int chosen = -1;
 
-        if (!placed.empty()) {
-            double avg = 0;
-            for (int u : placed)
-                assignment[u] != -1 ? avg += assignment[u] : 0;
-            avg /= placed.size();
-
-            double best = 1e18;
-            for (int idx : position_order) {
-                if (!used[idx]) {
-                    double d = fabs(idx - avg);
-                    if (d < best) {
-                        best = d;
-                        chosen = idx;
-                    }
-                }
+        if (placed > 0) {
+            avg /= placed;
+
+            int below = free_idx.predecessor((int)floor(avg));
+            int above = free_idx.successor((int)ceil(avg));
+            if (below < 0) chosen = above;
+            else if (above < 0) chosen = below;
+            else {
+                double d_below = fabs(below - avg);
+                double d_above = fabs(above - avg);
+                if (d_below != d_above) chosen = d_below < d_above ? below : above;
+                else chosen = rank[below] < rank[above] ? below : above;
             }
         }
 
@@ -183,7 +259,59 @@ vector<int> barycentric_assignment(
             chosen = next_free();
 
         assignment[v] = chosen;
-        used[chosen] = true;
+        free_idx.take(chosen);
+    }
+
+    return assignment;
+}
+
+//------------------------------------------------------------
+// 2D barycentric assignment: average of the neighbours' real coords,
+// nearest free cell through a k-d tree
+//------------------------------------------------------------
+vector<int> barycentric_2d_assignment(
+    int V,
+    const CsrGraph& g,
+    const vector<pair<double,double>>& coords,
+    const vector<int>& position_order,
+    const SolverControl& control)
+{
+    vector<int> assignment(V, -1);       // vertex -> grid index
+
+    // Only cells listed in position_order can be taken
+    KdTree free_cells(coords);
+    vector<char> listed(coords.size(), 0);
+    for (int idx : position_order)
+        if (idx >= 0 && idx < (int)coords.size()) listed[idx] = 1;
+    for (int idx = 0; idx < (int)coords.size(); idx++)
+        if (!listed[idx]) free_cells.remove(idx);
+
+    size_t cursor = 0;
+    auto next_free = [&]() -> int {
+        while (cursor < position_order.size() && !free_cells.contains(position_order[cursor]))
+            cursor++;
+        return cursor < position_order.size() ? position_order[cursor] : -1;
+    };
+
+    // After a cancel the remaining vertices just take the next free cell
+    bool stopped = false;
+    for (int v = 0; v < V; v++) {
+        if (v % 256 == 0 && !stopped) stopped = control.cancelled();
+        double ax = 0, ay = 0;
+        int placed = 0;
+        for (int u : g.neighbours(v))
+            if (assignment[u] != -1) {
+                ax += coords[assignment[u]].first;
+                ay += coords[assignment[u]].second;
+                placed++;
+            }
+
+        int chosen = placed > 0 && !stopped ? free_cells.nearest(ax / placed, ay / placed) : -1;
+        if (chosen == -1)
+            chosen = next_free();
+
+        assignment[v] = chosen;
+        free_cells.remove(chosen);
     }
 
     return assignment;
@@ -194,7 +322,7 @@ vector<int> barycentric_assignment(
 //------------------------------------------------------------
 vector<int> degree_greedy_assignment(
     int V,
-    const vector<vector<int>>& adj,
+    const CsrGraph& g,
     const vector<int>& position_order)
 {
     vector<int> assignment(V, -1);
@@ -202,7 +330,7 @@ vector<int> degree_greedy_assignment(
 
     vector<int> deg(V);
     for (int i = 0; i < V; i++)
-        deg[i] = adj[i].size();
+        deg[i] = g.degree(i);
 
     vector<int> order(V);
     for (int i = 0; i < V; i++) order[i] = i;
@@ -242,27 +370,20 @@ double get_dist(int pos_idx1, int pos_idx2, const vector<pair<double, double>>&
     return sqrt(dx*dx + dy*dy);
 }
 
-// Calculates local "Stress" (sum of edge lengths) for a specific vertex u
-double get_vertex_stress(int u, const vector<vector<int>>& adj, const vector<int>& assignment, const vector<pair<double, double>>& coords) {
-    double stress = 0.0;
-    int u_pos = assignment[u];
-    for (int v : adj[u]) {
-        if (assignment[v] != -1) {
-            stress += get_dist(u_pos, assignment[v], coords);
-        }
-    }
-    return stress;
-}
-
 // The new Heuristic Function
 vector<int> distance_refinement_assignment(
     int V,
-    const vector<vector<int>>& adj,
+    const CsrGraph& g,
     const vector<int>& initial_assignment,
     const vector<pair<double, double>>& coords,
     double target_d,
-    int r)
+    int r,
+    unsigned seed,
+    const SolverControl& control)
 {
+    // Own generator: runs are reproducible and safe to execute concurrently
+    mt19937 rng(seed);
+
     // Start with the best previous assignment
     vector<int> A = initial_assignment;
 
@@ -274,14 +395,45 @@ vector<int> distance_refinement_assignment(
         }
     }
 
-    // Collect all edges for easier iteration
-    vector<pair<int, int>> edges;
-    for(int u=0; u<V; ++u) {
-        for(int v : adj[u]) {
-            if(u < v) edges.push_back({u, v});
-        }
+    // Edges come flat from the CSR graph; incidence for the swap updates
+    const vector<pair<int, int>>& edges = g.edges;
+    vector<vector<int>> incident(V);   // vertex -> edge ids
+    for(int e=0; e<(int)edges.size(); ++e) {
+        incident[edges[e].first].push_back(e);
+        incident[edges[e].second].push_back(e);
     }
 
+    // "Bad Edges" (Length > d) as an indexed set: O(1) insert, erase and
+    // random pick. Only edges incident to a swapped vertex change length,
+    // so the set is updated from their incidence lists after every swap.
+    vector<int> bad_edges;
+    vector<int> bad_slot(edges.size(), -1);
+    auto update_bad = [&](int e) {
+        bool is_bad = get_dist(A[edges[e].first], A[edges[e].second], coords) > target_d;
+        if (is_bad && bad_slot[e] < 0) {
+            bad_slot[e] = (int)bad_edges.size();
+            bad_edges.push_back(e);
+        } else if (!is_bad && bad_slot[e] >= 0) {
+            int last = bad_edges.back();
+            bad_edges[bad_slot[e]] = last;
+            bad_slot[last] = bad_slot[e];
+            bad_edges.pop_back();
+            bad_slot[e] = -1;
+        }
+    };
+    for(int e=0; e<(int)edges.size(); ++e) update_bad(e);
+
+    // Change of the summed edge length when x moves from p_from to p_to,
+    // ignoring edges to 'other' (they keep their length in a swap)
+    auto move_gain = [&](int x, int other, int p_from, int p_to) {
+        double gain = 0.0;
+        for (int y : g.neighbours(x)) {
+            if (y == other || A[y] == -1) continue;
+            gain += get_dist(p_from, A[y], coords) - get_dist(p_to, A[y], coords);
+        }
+        return gain;
+    };
+
     int max_iterations = 2500;
     int neighborhood_radius = (int)ceil(target_d);
 
@@ -289,18 +441,15 @@ vector<int> distance_refinement_assignment(
     // cerr << "Starting Distance Refinement..." << endl;
 
     for(int iter=0; iter<max_iterations; ++iter) {
-        // 1. Identify "Bad Edges" (Length > d)
-        vector<pair<int, int>> bad_edges;
-        for(auto& e : edges) {
-            if(get_dist(A[e.first], A[e.second], coords) > target_d) {
-                bad_edges.push_back(e);
-            }
+        if (iter % 64 == 0) {
+            if (control.cancelled()) break;
+            control.report(50 + 40 * iter / max_iterations);
         }
 
         if(bad_edges.empty()) break; // Optimization achieved!
 
         // 2. Pick random bad edge (u, v)
-        pair<int, int> bad = bad_edges[rand() % bad_edges.size()];
+        pair<int, int> bad = edges[bad_edges[rng() % bad_edges.size()]];
         int u = bad.first;
         int v = bad.second;
 
@@ -328,26 +477,10 @@ vector<int> distance_refinement_assignment(
                 // If w is -1 or same as u/v, skip
                 if(w == -1 || w == u || w == v) continue;
 
-                // --- Calculate Gain if we swap u and w ---
-                double u_stress_before = get_vertex_stress(u, adj, A, coords);
-                double w_stress_before = get_vertex_stress(w, adj, A, coords);
-
-                // Actual swap logic using CURRENT assignments
+                // --- Gain if we swap u and w, from their neighbourhoods only ---
                 int p_u = A[u];
                 int p_w = A[w];
-
-                // Swap in assignment
-                A[u] = p_w;
-                A[w] = p_u;
-
-                double u_stress_after = get_vertex_stress(u, adj, A, coords);
-                double w_stress_after = get_vertex_stress(w, adj, A, coords);
-
-                // Revert assignment for next iteration check
-                A[u] = p_u;
-                A[w] = p_w;
-
-                double gain = (u_stress_before + w_stress_before) - (u_stress_after + w_stress_after);
+                double gain = move_gain(u, w, p_u, p_w) + move_gain(w, u, p_w, p_u);
 
                 if(gain > best_gain) {
                     best_gain = gain;
@@ -368,6 +501,9 @@ vector<int> distance_refinement_assignment(
             // Update reverse map
             pos_to_v[p_u] = best_w;
             pos_to_v[p_w] = u;
+
+            for (int e : incident[u]) update_bad(e);
+            for (int e : incident[best_w]) update_bad(e);
         }
     }
     return A;
@@ -377,43 +513,237 @@ vector<int> distance_refinement_assignment(
 //------------------------------------------------------------
 
 //------------------------------------------------------------
-// --- Brute force for low V ---
+// --- Exact search for low V (branch and bound) ---
 //------------------------------------------------------------
 
-std::vector<int> brute_force_layout(
+// Searches every assignment of the V vertices to the first V grid positions.
+// Vertices are placed one at a time and the crossings of every completed edge
+// are added as it appears, so a partial assignment is dropped as soon as it
+// reaches the incumbent. The incumbent starts at the best heuristic result;
+// only strictly better layouts are returned, an empty vector means none was
+// found. After timeLimitMs the best layout seen so far is returned without
+// the optimality guarantee.
+
+namespace {
+
+struct ExactSearch {
+    int V;
+    const vector<char>& crosses;         // slot segment ab crosses slot segment cd
+    const vector<int>& order;            // placement order
+    const vector<vector<int>>& back;     // back[i]: earlier neighbours of order[i]
+    const vector<int>& twinPrev;         // twin that must sit on a lower slot
+    atomic<int>& bound;
+    atomic<bool>& stop;
+    mutex& bestMutex;
+    vector<int>& best;
+    const SolverControl& control;
+    chrono::steady_clock::time_point deadline;
+
+    vector<int> slotOf = {};
+    vector<pair<int,int>> placed = {};   // completed edges as slot pairs
+    unsigned used = 0;
+    long long nodes = 0;
+
+    bool cross(int a, int b, int c, int d) const
+    {
+        return crosses[((size_t)(a * V + b) * V + c) * V + d] != 0;
+    }
+
+    // Crossings added by putting order[i] on slot s, stops early past limit
+    int added(int i, int s, int limit) const
+    {
+        int c = 0;
+        for (int w : back[i]) {
+            int t = slotOf[w];
+            for (const auto& e : placed)
+                if (cross(s, t, e.first, e.second) && ++c >= limit) return c;
+        }
+        return c;
+    }
+
+    void place(int i, int s)
+    {
+        slotOf[order[i]] = s;
+        used |= 1u << s;
+        for (int w : back[i]) placed.emplace_back(s, slotOf[w]);
+    }
+
+    void unplace(int i, int s)
+    {
+        placed.resize(placed.size() - back[i].size());
+        used &= ~(1u << s);
+        slotOf[order[i]] = -1;
+    }
+
+    // First free slot order[i] may take (twins are kept in slot order)
+    int firstSlot(int i) const
+    {
+        int u = twinPrev[order[i]];
+        return u >= 0 ? slotOf[u] + 1 : 0;
+    }
+
+    void extend(int i, int partial)
+    {
+        if (stop.load(memory_order_relaxed)) return;
+        if ((++nodes & 4095) == 0 &&
+            (control.cancelled() || chrono::steady_clock::now() > deadline)) {
+            stop = true;
+            return;
+        }
+
+        if (i == V) {
+            lock_guard<mutex> lock(bestMutex);
+            if (partial < bound.load()) {
+                bound = partial;
+                best = slotOf;
+            }
+            return;
+        }
+
+        // Cheapest slots first, so good incumbents are found early
+        vector<pair<int,int>> moves;
+        for (int s = firstSlot(i); s < V; s++) {
+            if (used & (1u << s)) continue;
+            int limit = bound.load(memory_order_relaxed) - partial;
+            int c = added(i, s, limit);
+            if (c < limit) moves.emplace_back(c, s);
+        }
+        sort(moves.begin(), moves.end());
+
+        for (const auto& m : moves) {
+            if (partial + m.first >= bound.load(memory_order_relaxed)) break;
+            place(i, m.second);
+            extend(i + 1, partial + m.first);
+            unplace(i, m.second);
+        }
+    }
+};
+
+} // namespace
+
+std::vector<int> branch_and_bound_layout(
     int V,
-    const std::vector<std::vector<int>>& adj,
-    const std::vector<std::pair<double, double>>& coords)
+    const CsrGraph& g,
+    const std::vector<std::pair<double, double>>& coords,
+    int upperBound,
+    const SolverControl& control,
+    int timeLimitMs)
 {
-    int best_crossings = std::numeric_limits<int>::max();
-    std::vector<int> best_assignment(V);
+    if (V <= 0 || V > ExactMaxVertices || (int)coords.size() < V) return {};
+
+    // Crossing table over the V candidate slots
+    vector<char> crosses((size_t)V * V * V * V, 0);
+    for (int a = 0; a < V; a++)
+        for (int b = 0; b < V; b++)
+            for (int c = 0; c < V; c++)
+                for (int d = 0; d < V; d++) {
+                    if (a == b || c == d || a == c || a == d || b == c || b == d) continue;
+                    crosses[((size_t)(a * V + b) * V + c) * V + d] =
+                        CrossingCounter::segmentsIntersect(
+                            coords[a].first, coords[a].second, coords[b].first, coords[b].second,
+                            coords[c].first, coords[c].second, coords[d].first, coords[d].second);
+                }
 
-    // Prepare list of grid indices: choose first V.
-    std::vector<int> grid_indices(V);
-    for (int i = 0; i < V; ++i) grid_indices[i] = i;
+    // Neighbour lists without loops (duplicates kept, they are parallel edges)
+    vector<vector<int>> nb(V);
+    for (int v = 0; v < V && v < g.vertexCount(); v++) {
+        for (int w : g.neighbours(v))
+            if (w < V && w != v) nb[v].push_back(w);
+        sort(nb[v].begin(), nb[v].end());
+    }
 
-    std::vector<int> current_assignment = grid_indices; // vertices â grid position
+    // Placement order: most edges to already placed vertices, then degree
+    vector<int> order, rank(V, -1), link(V, 0);
+    for (int i = 0; i < V; i++) {
+        int pick = -1;
+        for (int v = 0; v < V; v++) {
+            if (rank[v] >= 0) continue;
+            if (pick < 0 || link[v] > link[pick] ||
+                (link[v] == link[pick] && nb[v].size() > nb[pick].size()))
+                pick = v;
+        }
+        rank[pick] = i;
+        order.push_back(pick);
+        for (int w : nb[pick]) link[w]++;
+    }
 
-    do {
-        // Create positions: vertex v assigned to coords[current_assignment[v]]
-        std::vector<std::pair<double, double>> layout(V);
-        for (int v = 0; v < V; ++v)
-            layout[v] = coords[current_assignment[v]];
+    vector<vector<int>> back(V);
+    for (int v = 0; v < V; v++)
+        for (int w : nb[v])
+            if (rank[w] < rank[v]) back[rank[v]].push_back(w);
+
+    // The perturbed grid has no geometric symmetry left, but the graph can:
+    // twins (same neighbourhood, open or closed) are interchangeable, so only
+    // the assignment that keeps each twin class in slot order is searched.
+    auto twins = [&](int u, int v) {
+        bool adjacent = binary_search(nb[u].begin(), nb[u].end(), v);
+        if (!adjacent) return nb[u] == nb[v];
+        vector<int> cu = nb[u], cv = nb[v];
+        cu.insert(lower_bound(cu.begin(), cu.end(), u), u);
+        cv.insert(lower_bound(cv.begin(), cv.end(), v), v);
+        return cu == cv;
+    };
+    vector<int> twinPrev(V, -1);
+    for (int i = 1; i < V; i++)
+        for (int j = i - 1; j >= 0; j--)
+            if (twins(order[j], order[i])) { twinPrev[order[i]] = order[j]; break; }
+
+    atomic<int> bound(upperBound);
+    atomic<bool> stop(false);
+    mutex bestMutex;
+    vector<int> best;
+    const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs);
+
+    auto makeSearch = [&]() {
+        ExactSearch s{V, crosses, order, back, twinPrev, bound, stop, bestMutex, best, control, deadline};
+        s.slotOf.assign(V, -1);
+        return s;
+    };
 
-        int crossings = countCrossingsSolver(layout, adj);
+    // Subtrees below the first two placements run as separate pool tasks
+    // and share the incumbent
+    const int depth = min(V, 2);
+    vector<vector<int>> prefixes;
+    {
+        ExactSearch s = makeSearch();
+        vector<int> prefix;
+        function<void(int)> enumerate = [&](int i) {
+            if (i == depth) { prefixes.push_back(prefix); return; }
+            for (int slot = s.firstSlot(i); slot < V; slot++) {
+                if (s.used & (1u << slot)) continue;
+                s.place(i, slot);
+                prefix.push_back(slot);
+                enumerate(i + 1);
+                prefix.pop_back();
+                s.unplace(i, slot);
+            }
+        };
+        enumerate(0);
+    }
 
-        if (crossings <= best_crossings) {
-            best_crossings = crossings;
-            best_assignment = current_assignment;
-        }
-    } while (std::next_permutation(current_assignment.begin(), current_assignment.end()));
+    ThreadPool& pool = ThreadPool::shared();
+    vector<future<void>> tasks;
+    tasks.reserve(prefixes.size());
+    for (const auto& prefix : prefixes)
+        tasks.push_back(pool.submit([&, prefix]() {
+            ExactSearch s = makeSearch();
+            int partial = 0;
+            for (int i = 0; i < depth; i++) {
+                partial += s.added(i, prefix[i], numeric_limits<int>::max());
+                s.place(i, prefix[i]);
+            }
+            if (partial < bound.load()) s.extend(depth, partial);
+        }));
+    for (auto& t : tasks) pool.wait(t);
 
-    return best_assignment;
+    if (stop && !control.cancelled())
+        trace("exact search hit the time limit");
+    return best;
 }
 
 
 //------------------------------------------------------------
-// --- End of Brute force ---
+// --- End of exact search ---
 //------------------------------------------------------------
 
 
@@ -422,49 +752,73 @@ std::vector<int> brute_force_layout(
 //------------------------------------------------------------
 
 
-std::pair<int, std::vector<std::pair<double,double>>> Solver::computeLayout(int V, int E, const vector<vector<int>>& adj, int heuristicIndex) {
-    qDebug() << E;
+std::pair<int, std::vector<std::pair<double,double>>> Solver::computeLayout(int V, int E, const vector<vector<int>>& adj, int heuristicIndex, const SolverControl& control, unsigned seed) {
+    trace("edges ", E);
+
+    // Flat copy of the graph shared by the planarity test and all heuristics
+    const CsrGraph graph(adj, V);
+
+    // Components never cross each other: lay them out apart
+    vector<vector<int>> components = connected_components(graph);
+    if (components.size() > 1)
+        return layoutComponents(graph, components, heuristicIndex, control, seed);
+
+    return layoutConnected(graph, E, heuristicIndex, control, seed,
+                           TimeLimits{ExactTimeLimitMs, AnnealingTimeLimitMs}, false);
+}
+
+int Solver::crossingEstimate(const CsrGraph& graph, int E, bool testPlanarity) {
+    const int V = graph.vertexCount();
+    if (V == 0) return 0;
 
     double C = 4.108;
     double ratio = (double)E / (C * (double)V);
     long long k = (long long)ceil(ratio * ratio);
 
-    if(isPlanar(adj) == true)
+    if(testPlanarity && isPlanar(graph) == true)
         k = 0;
+    return (int)k;
+}
 
-    long long r = (long long)ceil(sqrt((double)V)) * 4 / 3 + 1;
-    double perturb = 2;
+Solver::Layout Solver::layoutConnected(const CsrGraph& graph, int E, int heuristicIndex, const SolverControl& control, unsigned seed, TimeLimits limits, bool quiet) {
+    const int V = graph.vertexCount();
 
-    mt19937 rng(123456);
-    uniform_real_distribution<double> d(-perturb, perturb);
+    // Choose assignment based on UI-selected heuristic index
+    int h = heuristicIndex;
+    if (h < 0) h = 0;
+    if (h >= HeuristicCount) h = HeuristicCount - 1;
+
+    // Only build what the selected mode can return. Crossings are only
+    // needed to compare candidates: in "best" mode, or against the exact search.
+    // Annealing starts from what "best" would return.
+    const bool anneal     = (h == AnnealingHeuristic);
+    const bool all        = (h == BestHeuristic) || anneal;
+    auto wants = [&](int heuristic) { return all || h == heuristic; };
+    const bool wantExact  = V <= ExactMaxVertices;
+    const bool needScore  = all || wantExact;
+
+    long long r = grid_side(V);
+
+    // A planar graph is drawn straight from its embedding in the modes that
+    // minimize crossings: 0 crossings, and none of the heuristics need to run
+    vector<pair<double,double>> planarDrawing;
+    if (all) planarDrawing = planar_straight_line_drawing(graph);
+    if (!planarDrawing.empty()) {
+        if (control.cancelled()) return {0, {}};
+        if (!quiet) trace("planar straight-line drawing");
+        control.report(100);
+        return {0, spaceDrawing(std::move(planarDrawing))};
+    }
 
-    // FIX: coords must hold ALL grid positions (r*r)
-    vector<pair<double,double>> coords;
-    coords.reserve(r * r);
+    // In those modes the graph is known not to be planar by now
+    long long k = crossingEstimate(graph, E, !all);
 
-    for (long long i = 0; i < r; i++) {
-        for (long long j = 0; j < r; j++) {
-            double x = (double)j + d(rng);
-            double y = (double)i + d(rng);
-            coords.emplace_back(x, y);
-        }
-    }
+    // FIX: coords must hold ALL grid positions (r*r)
+    vector<pair<double,double>> coords = perturbed_grid((int)r, seed);
 
     vector<int> spiral = spiralOrder(r);
     ///spiral.resize(V);
 
-    vector<int> A_spiral      = spiral_assignment(V, spiral);
-    vector<int> A_degree      = degree_greedy_assignment(V, adj, spiral);
-    vector<int> A_barycentric = barycentric_assignment(V, adj, spiral);
-    vector<int> A_brute;
-    if (V < 10)
-    {
-        A_brute = brute_force_layout(V, adj, coords);
-    }
-
-    // 4th Heuristic Call
-    double target_d = sqrt((2.0 * E) / (M_PI * V));
-    vector<int> A_refined = distance_refinement_assignment(V, adj, A_barycentric, coords, target_d, (int)r);
     /*
     g << "Computed_k = " << k << "\n";
     g << "Grid size r = " << r << "\n";
@@ -499,58 +853,111 @@ std::pair<int, std::vector<std::pair<double,double>>> Solver::computeLayout(int
     ///qDebug() << V;
     ///qDebug() << coords.size();
 
-    vector<pair<double,double>> layoutSpiral      = buildLayout(A_spiral);
-    vector<pair<double,double>> layoutDegree      = buildLayout(A_degree);
-    vector<pair<double,double>> layoutBary        = buildLayout(A_barycentric);
-    vector<pair<double,double>> layoutRefined     = buildLayout(A_refined);
-
-    vector<int> crossings(4);
-    crossings[0] = countCrossingsSolver(layoutSpiral,  adj);
-    crossings[1] = countCrossingsSolver(layoutDegree,  adj);
-    crossings[2] = countCrossingsSolver(layoutBary,    adj);
-    crossings[3] = countCrossingsSolver(layoutRefined, adj);
-
-    int bestIndex = 0;
-    int bestVal = crossings[0];
-    for (int i = 1; i < 4; i++) {
-        if (crossings[i] <= bestVal) {
-            bestVal = crossings[i];
-            bestIndex = i;
-        }
-    }
+    struct Candidate {
+        vector<int> A;
+        int crossings = numeric_limits<int>::max();
+    };
 
-    qDebug() << bestIndex;
+    auto score = [&](vector<int> A) {
+        Candidate c;
+        c.A = std::move(A);
+        if (needScore && !control.cancelled())
+            c.crossings = countCrossingsSolver(buildLayout(c.A), graph);
+        return c;
+    };
 
-    // Choose assignment based on UI-selected heuristic index
-    int h = heuristicIndex;
-    if (h < 0) h = 0;
-    if (h > 4) h = 4;
+    // Portfolio: every candidate and its crossing count is one pool task,
+    // indexed by selector entry (slot BestHeuristic stays empty)
+    ThreadPool& pool = ThreadPool::shared();
+    future<Candidate> pending[HeuristicCount];
+
+    if (wants(SpiralHeuristic))
+        pending[SpiralHeuristic] = pool.submit([&]() { return score(spiral_assignment(V, spiral)); });
+    if (wants(DegreeHeuristic))
+        pending[DegreeHeuristic] = pool.submit([&]() { return score(degree_greedy_assignment(V, graph, spiral)); });
+    if (wants(MultilevelHeuristic))
+        pending[MultilevelHeuristic] = pool.submit([&]() {
+            return score(multilevel_assignment(V, graph, coords, (int)r, seed, control));
+        });
+    if (wants(ForceDirectedHeuristic))
+        pending[ForceDirectedHeuristic] = pool.submit([&]() {
+            return score(force_directed_assignment(V, graph, coords, (int)r, seed, control));
+        });
+
+    // Both barycentric placements run side by side; the refinement starts
+    // from each of them
+    future<vector<int>> fBaryAssign, fBary2DAssign;
+    if (wants(BarycentricHeuristic) || wants(RefinedHeuristic))
+        fBaryAssign = pool.submit([&]() { return barycentric_assignment(V, graph, spiral); });
+    if (wants(Barycentric2DHeuristic) || wants(Refined2DHeuristic))
+        fBary2DAssign = pool.submit([&]() { return barycentric_2d_assignment(V, graph, coords, spiral); });
+
+    double target_d = target_distance(V, E);
+    auto refineFrom = [&](future<vector<int>>& placement, int plainEntry, int refinedEntry) {
+        if (!placement.valid()) return;
+        vector<int> A = pool.wait(placement);
+
+        if (wants(plainEntry))
+            pending[plainEntry] = pool.submit([&, A]() { return score(A); });
+        if (wants(refinedEntry))
+            pending[refinedEntry] = pool.submit([&, A]() {
+                return score(distance_refinement_assignment(V, graph, A, coords, target_d, (int)r, seed, control));
+            });
+    };
+    refineFrom(fBaryAssign, BarycentricHeuristic, RefinedHeuristic);
+    refineFrom(fBary2DAssign, Barycentric2DHeuristic, Refined2DHeuristic);
+    control.report(30);
+
+    Candidate cand[HeuristicCount];
+    bool built[HeuristicCount] = {};
+    for (int i = SpiralHeuristic; i < HeuristicCount; i++)
+        if (pending[i].valid()) {
+            cand[i] = pool.wait(pending[i]);
+            built[i] = true;
+        }
+    control.report(wantExact ? 90 : 95);
+
+    if (control.cancelled()) return {(int)k, {}};
 
     const std::vector<int>* chosenA = nullptr;
-    if(h != 0)
-        switch (h) {
-        case 1: chosenA = &A_spiral; break;           // Spiral heuristic
-        case 2: chosenA = &A_degree; break;           // Degree greedy heuristic
-        case 3: chosenA = &A_barycentric; break;      // Barycentric heuristic
-        case 4: default: chosenA = &A_refined; break; // Distance refined barycentric heuristic
+    int chosenVal = numeric_limits<int>::max();
+    if (all) {
+        int bestIndex = -1;
+        for (int i = SpiralHeuristic; i < HeuristicCount; i++) {
+            if (!built[i]) continue;
+            if (bestIndex < 0 || cand[i].crossings <= chosenVal) {
+                chosenVal = cand[i].crossings;
+                bestIndex = i;
+            }
         }
-    if(h == 0){
-        switch (bestIndex) {
-        case 0: chosenA = &A_spiral; break;
-        case 1: chosenA = &A_degree; break;
-        case 2: chosenA = &A_barycentric; break;
-        case 3: chosenA = &A_refined; break;
-        default: chosenA = &A_degree; break;
+        if (!quiet) trace("best heuristic ", heuristicName(bestIndex));
+        chosenA = &cand[bestIndex].A;
+    } else {
+        chosenA = &cand[h].A;
+        chosenVal = cand[h].crossings;
+    }
+
+    // the exact search only keeps layouts that beat the chosen one
+    std::vector<int> exact;
+    if (wantExact)
+    {
+        exact = branch_and_bound_layout(V, graph, coords, chosenVal, control, limits.exactMs);
+        if (control.cancelled()) return {(int)k, {}};
+        if (!exact.empty()) {
+            if (!quiet) trace("exactCrossings ", countCrossingsSolver(buildLayout(exact), graph));
+            chosenA = &exact;
         }
+        control.report(95);
     }
 
-    // check the brute force solution
-    if (V < 10)
+    // Crossing search from the chosen layout, under its own time budget
+    std::vector<int> annealed;
+    if (anneal)
     {
-        vector<pair<double,double>> layoutBrute       = buildLayout(A_brute);
-        int bruteForceCrossings =  countCrossingsSolver(layoutBrute, adj);
-        qDebug() << "bruteForceCrossings " << bruteForceCrossings ;
-        if (bruteForceCrossings <  bestVal) chosenA = &A_brute;
+        annealed = annealing_assignment(V, graph, *chosenA, coords, (int)r, seed, limits.annealingMs, control);
+        if (control.cancelled()) return {(int)k, {}};
+        if (!quiet) trace("annealedCrossings ", countCrossingsSolver(buildLayout(annealed), graph));
+        chosenA = &annealed;
     }
 
     std::vector<std::pair<double, double>> res;
@@ -564,5 +971,316 @@ std::pair<int, std::vector<std::pair<double,double>>> Solver::computeLayout(int
             res.emplace_back(0.0, 0.0);
     }
 
+    control.report(100);
     return {k, res};
 }
+
+
+//------------------------------------------------------------
+// Disconnected graphs: one layout per component, then packed
+//------------------------------------------------------------
+
+// Space between packed components, in grid units
+static const double ComponentGap = 2.0;
+
+Solver::Layout Solver::layoutComponents(const CsrGraph& graph, const vector<vector<int>>& components, int heuristicIndex, const SolverControl& control, unsigned seed) {
+    const int V = graph.vertexCount();
+    ThreadPool& pool = ThreadPool::shared();
+
+    // Isolated vertices share one square block instead of a solve each
+    vector<int> isolated;
+    vector<const vector<int>*> parts;
+    int exactParts = 0;
+    for (const auto& members : components) {
+        if (members.size() == 1) isolated.push_back(members[0]);
+        else parts.push_back(&members);
+        if (members.size() > 1 && (int)members.size() <= ExactMaxVertices) exactParts++;
+    }
+
+    // The exact search is the one slow step on small components: split its
+    // time limit so all of them together take about one limit per worker
+    int exactLimit = ExactTimeLimitMs;
+    if (exactParts > 0)
+        exactLimit = clamp(ExactTimeLimitMs * (int)pool.size() / exactParts, 10, ExactTimeLimitMs);
+
+    // Annealing gets a share of its budget by component size
+    auto annealingLimit = [&](int n) {
+        long long share = (long long)AnnealingTimeLimitMs * pool.size() * n / max(1, V);
+        return (int)clamp<long long>(share, 10, AnnealingTimeLimitMs);
+    };
+
+    // Vertex number inside its own component
+    vector<int> local(V);
+    for (const auto& members : components)
+        for (int i = 0; i < (int)members.size(); i++) local[members[i]] = i;
+
+    // Components share the caller's cancel flag and deadline; progress is
+    // reported per finished component
+    SolverControl partControl;
+    partControl.cancel = control.cancel;
+    partControl.deadline = control.deadline;
+
+    vector<future<Layout>> pending;
+    pending.reserve(parts.size());
+    for (const vector<int>* members : parts) {
+        pending.push_back(pool.submit([&, members]() {
+            // Local copy with vertices renumbered 0..n-1 in component order
+            const int n = (int)members->size();
+            vector<vector<int>> adj(n);
+            int degreeSum = 0;
+            for (int i = 0; i < n; i++)
+                for (int w : graph.neighbours((*members)[i])) {
+                    adj[i].push_back(local[w]);
+                    degreeSum++;
+                }
+
+            return layoutConnected(CsrGraph(adj, n), degreeSum / 2, heuristicIndex,
+                                   partControl, seed, TimeLimits{exactLimit, annealingLimit(n)}, true);
+        }));
+    }
+
+    // A disjoint union is k-planar when every component is: the graph's k
+    // is the largest of theirs
+    vector<Layout> layouts(parts.size());
+    int k = 0;
+    for (size_t i = 0; i < pending.size(); i++) {
+        layouts[i] = pool.wait(pending[i]);
+        k = max(k, layouts[i].first);
+        control.report((int)(100 * (i + 1) / (pending.size() + 1)));
+    }
+    if (control.cancelled()) return {k, {}};
+    for (const Layout& L : layouts)
+        if (L.second.empty()) return {k, {}};
+
+    if (!isolated.empty()) {
+        int side = (int)ceil(sqrt((double)isolated.size()));
+        Layout block;
+        for (int i = 0; i < (int)isolated.size(); i++)
+            block.second.emplace_back(i % side, i / side);
+        layouts.push_back(std::move(block));
+    }
+
+    // Bounding boxes, packed into one drawing
+    vector<pair<double,double>> low(layouts.size()), size(layouts.size());
+    for (size_t i = 0; i < layouts.size(); i++) {
+        const auto& P = layouts[i].second;
+        double x0 = P[0].first, x1 = x0, y0 = P[0].second, y1 = y0;
+        for (const auto& p : P) {
+            x0 = min(x0, p.first);  x1 = max(x1, p.first);
+            y0 = min(y0, p.second); y1 = max(y1, p.second);
+        }
+        low[i] = {x0, y0};
+        size[i] = {x1 - x0, y1 - y0};
+    }
+    vector<pair<double,double>> corner = pack_rectangles(size, ComponentGap);
+
+    vector<pair<double,double>> res(V);
+    for (size_t i = 0; i < layouts.size(); i++) {
+        const vector<int>& members = i < parts.size() ? *parts[i] : isolated;
+        const auto& P = layouts[i].second;
+        for (size_t j = 0; j < members.size(); j++)
+            res[members[j]] = {P[j].first - low[i].first + corner[i].first,
+                               P[j].second - low[i].second + corner[i].second};
+    }
+
+    trace("components ", components.size(), ", isolated vertices ", isolated.size());
+    control.report(100);
+    return {k, res};
+}
+
+//------------------------------------------------------------
+// Multi-start: independent seeds, best layout wins
+//------------------------------------------------------------
+
+std::pair<int, std::vector<std::pair<double,double>>> Solver::computeMultiStart(int V, int E, const vector<vector<int>>& adj, int heuristicIndex, int runs, int timeBudgetMs, const SolverControl& control) {
+    using Clock = chrono::steady_clock;
+    const auto deadline = Clock::now() + chrono::milliseconds(timeBudgetMs);
+    if (runs < 1) runs = 1;
+
+    struct Run {
+        bool done = false;
+        int crossings = numeric_limits<int>::max();
+        std::pair<int, std::vector<std::pair<double,double>>> layout;
+    };
+
+    // Runs share the caller's cancel flag; progress is reported per finished run
+    SolverControl runControl;
+    runControl.cancel = control.cancel;
+    const CsrGraph graph(adj, V);
+
+    ThreadPool& pool = ThreadPool::shared();
+    auto launch = [&](int i) {
+        return pool.submit([&, i]() {
+            Run run;
+            if (control.cancelled()) return run;
+
+            run.layout = computeLayout(V, E, adj, heuristicIndex, runControl, runSeed(i));
+            if ((int)run.layout.second.size() != V) return run;
+
+            run.crossings = countCrossingsSolver(run.layout.second, graph);
+            run.done = true;
+            return run;
+        });
+    };
+
+    // Keep about one run per worker in flight; a new run only starts while
+    // budget is left (the first run always completes)
+    const int window = max(1u, pool.size());
+    deque<future<Run>> inFlight;
+    int started = 0;
+    auto canStart = [&]() {
+        if (started >= runs || control.cancelled()) return false;
+        return started == 0 || timeBudgetMs <= 0 || Clock::now() < deadline;
+    };
+
+    Run best;
+    int finished = 0;
+    while (canStart() && (int)inFlight.size() < window)
+        inFlight.push_back(launch(started++));
+
+    while (!inFlight.empty()) {
+        Run run = pool.wait(inFlight.front());
+        inFlight.pop_front();
+        if (run.done && (!best.done || run.crossings < best.crossings))
+            best = std::move(run);
+
+        control.report(100 * ++finished / runs);
+        if (canStart())
+            inFlight.push_back(launch(started++));
+    }
+
+    if (control.cancelled() || !best.done) return {best.layout.first, {}};
+
+    trace("multi-start best crossings ", best.crossings);
+    return best.layout;
+}
+
+
+//------------------------------------------------------------
+// Anytime: the incumbent improves until the deadline
+//------------------------------------------------------------
+
+std::pair<int, std::vector<std::pair<double,double>>> Solver::computeAnytime(int V, int E, const vector<vector<int>>& adj, int budgetMs, const SolverControl& control) {
+    using Clock = SolverControl::Clock;
+
+    // Heuristics see the deadline as a cancel and return what they have
+    SolverControl timed;
+    timed.cancel = control.cancel;
+    timed.deadline = min(control.deadline, Clock::now() + chrono::milliseconds(max(0, budgetMs)));
+    auto remainingMs = [&]() {
+        return (int)chrono::duration_cast<chrono::milliseconds>(timed.deadline - Clock::now()).count();
+    };
+
+    const CsrGraph graph(adj, V);
+    if (V == 0) return {0, {}};
+
+    const int r = grid_side(V);
+    const vector<pair<double,double>> coords = perturbed_grid(r, DefaultSeed);
+    const vector<int> spiral = spiralOrder(r);
+
+    auto buildLayout = [&](const vector<int>& A) {
+        vector<pair<double,double>> L(V);
+        for (int v = 0; v < V; v++) L[v] = coords[A[v]];
+        return L;
+    };
+
+    // Counting crossings can take longer than the whole budget on dense
+    // drawings, so every count stops at the deadline
+    auto timedCount = [&](const vector<pair<double,double>>& L) {
+        return countCrossingsSolver(L, graph, [&]() { return timed.cancelled(); });
+    };
+
+    // 1. Fast first layout, shown before it is even counted. The 1D
+    //    barycentric stays near linear where the 2D one does not (its
+    //    nearest free cell searches grow on tangled graphs).
+    const vector<int> first = barycentric_assignment(V, graph, spiral);
+    vector<int> best = first;
+    int bestCrossings = -1;             // -1: not counted (yet)
+    if (control.improved) control.improved(buildLayout(best), -1);
+    control.report(10);
+
+    // Candidates are offered here. One that cannot be counted before the
+    // deadline is dropped; a counted one beats an uncounted incumbent.
+    mutex incumbentMutex;
+    double countMs = 0;                 // slowest count so far
+    auto offer = [&](const vector<int>& A) {
+        if ((int)A.size() != V || timed.cancelled()) return;
+        vector<pair<double,double>> L = buildLayout(A);
+        auto countStart = Clock::now();
+        int c = timedCount(L);
+        if (c < 0) return;
+
+        lock_guard<mutex> lock(incumbentMutex);
+        countMs = max(countMs, chrono::duration<double, milli>(Clock::now() - countStart).count());
+        if (A == best && bestCrossings < 0) {   // the incumbent itself, already shown
+            bestCrossings = c;
+            return;
+        }
+        if (bestCrossings >= 0 && c >= bestCrossings) return;
+        best = A;
+        bestCrossings = c;
+        if (control.improved) control.improved(L, c);
+    };
+
+    // 2. Portfolio under the deadline, along with the count of the first
+    //    layout; layouts that come back late are dropped rather than counted
+    ThreadPool& pool = ThreadPool::shared();
+
+    // The planar drawing (the planarity test behind k) takes seconds on
+    // large planar graphs and cannot stop at the deadline. Queued first, it
+    // goes to the first idle worker, while this thread, which helps with the
+    // newest tasks while it waits, takes the layouts below. It owns a copy
+    // of the graph, so a drawing still running at the deadline is left to
+    // finish on its own; one not started by then is skipped
+    auto planarGraph = make_shared<const CsrGraph>(graph);
+    future<vector<pair<double,double>>> fPlanar = pool.submit([planarGraph, deadline = timed.deadline]() {
+        if (Clock::now() >= deadline) return vector<pair<double,double>>();
+        return planar_straight_line_drawing(*planarGraph);
+    });
+
+    vector<future<void>> pending;
+    auto race = [&](function<vector<int>()> build) {
+        pending.push_back(pool.submit([&, build]() {
+            vector<int> A = build();
+            if (!timed.cancelled()) offer(A);
+        }));
+    };
+    race([&]() { return multilevel_assignment(V, graph, coords, r, DefaultSeed, timed); });
+    race([&]() { return force_directed_assignment(V, graph, coords, r, DefaultSeed, timed); });
+    race([&]() {
+        vector<int> bary2d = barycentric_2d_assignment(V, graph, coords, spiral, timed);
+        if (timed.cancelled()) return bary2d;
+        offer(bary2d);
+        return distance_refinement_assignment(V, graph, bary2d, coords, target_distance(V, E),
+                                              r, DefaultSeed, timed);
+    });
+    race([&]() { return first; });      // late: on few cores the others go first
+    for (auto& f : pending) pool.wait(f);
+    control.report(60);
+
+    // 3. Exact search on small graphs, then annealing with whatever is left.
+    //    Annealing opens with a full count and its result is counted again,
+    //    so time for two counts is kept aside.
+    if (V <= ExactMaxVertices && bestCrossings >= 0 && remainingMs() > 0)
+        offer(branch_and_bound_layout(V, graph, coords, bestCrossings, timed, remainingMs()));
+
+    const int annealingMs = remainingMs() - (int)ceil(2 * countMs) - 1;
+    if (bestCrossings > 0 && annealingMs > 0) {
+        vector<int> start = best;
+        offer(annealing_assignment(V, graph, start, coords, r, DefaultSeed, annealingMs, timed));
+    }
+
+    // A planar drawing beats any grid layout: it has no crossings. It is
+    // taken if it is ready by the deadline
+    vector<pair<double,double>> planarDrawing;
+    if (!control.abandoned() && fPlanar.wait_until(timed.deadline) == future_status::ready)
+        planarDrawing = fPlanar.get();
+    if (control.abandoned()) return {planarDrawing.empty() ? crossingEstimate(graph, E, false) : 0, {}};
+    control.report(100);
+    if (!planarDrawing.empty()) {
+        planarDrawing = spaceDrawing(std::move(planarDrawing));
+        if (control.improved) control.improved(planarDrawing, 0);
+        return {0, planarDrawing};
+    }
+    return {crossingEstimate(graph, E, false), buildLayout(best)};
+}
@@ -1,20 +1,129 @@
 #pragma once
 #include <vector>
 #include <utility>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+class CsrGraph;
+
+// Hooks for running the solver off the UI thread
+struct SolverControl {
+    using Clock = std::chrono::steady_clock;
+
+    const std::atomic<bool>* cancel = nullptr;   // raised by the caller to abandon the solve
+    std::function<void(int)> progress;           // percent done, 0..100
+
+    // Anytime solves: work stops at the deadline, and every new incumbent
+    // (solver coordinates; crossings, -1 if not counted) goes to improved
+    // as soon as it is found
+    Clock::time_point deadline = Clock::time_point::max();
+    std::function<void(const std::vector<std::pair<double, double>>&, int)> improved;
+
+    bool abandoned() const { return cancel && cancel->load(std::memory_order_relaxed); }
+    bool expired() const { return deadline != Clock::time_point::max() && Clock::now() >= deadline; }
+
+    // Polled by the heuristics: stop on cancel or at the deadline
+    bool cancelled() const { return abandoned() || expired(); }
+    void report(int percent) const { if (progress) progress(percent); }
+};
 
 class Solver {
 public:
+    // Entries of the UI heuristic selector, in order
+    enum Heuristic {
+        BestHeuristic = 0,          // every candidate, fewest crossings wins
+        SpiralHeuristic,
+        DegreeHeuristic,
+        BarycentricHeuristic,
+        RefinedHeuristic,           // distance refined barycentric
+        Barycentric2DHeuristic,     // barycenter of real coords, nearest free cell
+        Refined2DHeuristic,         // distance refined 2D barycentric
+        MultilevelHeuristic,        // coarsen, lay out, project back and refine
+        ForceDirectedHeuristic,     // Barnes-Hut force-directed, snapped to the grid
+        AnnealingHeuristic,         // best candidate, then annealing on crossings
+        HeuristicCount
+    };
+
     ///struct Result {
         ///std::vector<std::pair<double,double>> coords;   // P_i.x , P_i.y
         ///std::vector<int> assignment;                    // node v → point index P_i
         ///int r;                                          // grid size
     ///};
 
+    // Short names of the Heuristic entries ("best", "spiral", ...), for tools
+    static const char* heuristicName(int heuristicIndex);
+
+    // Diagnostics on stderr, on by default
+    static void setVerbose(bool on);
+
+    // Seed of the grid perturbation and refinement of a single run
+    static constexpr unsigned DefaultSeed = 123456;
+    static unsigned runSeed(int run) { return DefaultSeed + 0x9E3779B9u * (unsigned)run; }
+
+    // Raised whenever a change makes the same input lay out differently;
+    // cached layouts of another version are not reused
+    static constexpr unsigned LayoutVersion = 2;
+
     // Main function you will call from UI
+    // A cancelled solve returns an empty layout.
     static std::pair<int, std::vector<std::pair<double, double>>> computeLayout(
         int V,
         int E,
         const std::vector<std::vector<int>>& adj,
-        int heuristicIndex
+        int heuristicIndex,
+        const SolverControl& control = SolverControl(),
+        unsigned seed = DefaultSeed
         );
+
+    // Runs computeLayout with `runs` different seeds in parallel and keeps the
+    // layout with the fewest crossings. With timeBudgetMs > 0 no new run starts
+    // after the budget is spent (the first run always completes).
+    static std::pair<int, std::vector<std::pair<double, double>>> computeMultiStart(
+        int V,
+        int E,
+        const std::vector<std::vector<int>>& adj,
+        int heuristicIndex,
+        int runs,
+        int timeBudgetMs = 0,
+        const SolverControl& control = SolverControl()
+        );
+
+    // Anytime counterpart of the "best" entry: the best layout found within
+    // budgetMs. Every improvement is passed to control.improved on the way.
+    // The first layout (barycentric) and the planarity test are always
+    // completed, even past the budget; a planar graph gets its crossing-free
+    // drawing. Only a cancel returns an empty layout.
+    static std::pair<int, std::vector<std::pair<double, double>>> computeAnytime(
+        int V,
+        int E,
+        const std::vector<std::vector<int>>& adj,
+        int budgetMs,
+        const SolverControl& control = SolverControl()
+        );
+
+private:
+    using Layout = std::pair<int, std::vector<std::pair<double, double>>>;
+
+    // k shown by the UI: 0 for planar graphs, else the density estimate.
+    // Without testPlanarity the graph is taken as non-planar.
+    static int crossingEstimate(const CsrGraph& graph, int E, bool testPlanarity = true);
+
+    // Wall-clock caps of the open-ended steps of one solve
+    struct TimeLimits {
+        int exactMs;
+        int annealingMs;
+    };
+
+    // computeLayout on one connected graph; quiet drops the per-solve
+    // diagnostics
+    static Layout layoutConnected(const CsrGraph& graph, int E, int heuristicIndex,
+                                  const SolverControl& control, unsigned seed,
+                                  TimeLimits limits, bool quiet);
+
+    // Every component on its own grid and pool task, then packed into one drawing
+    static Layout layoutComponents(const CsrGraph& graph,
+                                   const std::vector<std::vector<int>>& components,
+                                   int heuristicIndex, const SolverControl& control,
+                                   unsigned seed);
 };
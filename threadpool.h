@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <chrono>
+
+// Fixed-size worker pool shared by the solver's parallel stages.
+// Tasks may submit and wait for sub-tasks: wait() runs queued work
+// while the awaited result is not ready, so nesting cannot deadlock.
+// Workers take the oldest task, waiters the newest one, which is usually
+// a sub-task of the computation being waited for.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency())
+    {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; i++)
+            workers.emplace_back([this]() { workerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the machine
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    template <class F>
+    auto submit(F&& f) -> std::future<decltype(f())>
+    {
+        using R = decltype(f());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.emplace_back([task]() { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    template <class R>
+    R wait(std::future<R>& f)
+    {
+        while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runOne())
+                f.wait_for(std::chrono::milliseconds(1));
+        }
+        return f.get();
+    }
+
+private:
+    bool runOne()
+    {
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queue.empty()) return false;
+            job = std::move(queue.back());
+            queue.pop_back();
+        }
+        job();
+        return true;
+    }
+
+    void workerLoop()
+    {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (stopping && queue.empty()) return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};